@@ -2,18 +2,100 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <limits.h>
+#include <stdint.h>
 #include "chessSystem.h"
 #include "map.h"
 #include "tournament.h"
 #include "game.h"
-#include "list.h"
 #include "player.h"
 
+#define CHESS_SAVE_BUFFER_SIZE (1 << 16)
+#define CHESS_TEMP_FILE_SUFFIX ".tmp"
+
+/**
+ * The snapshot layout. integers are int32_t in the byte order of the machine which saved the snapshot.
+ *   header:      magic, version, journal generation, amount of tournaments
+ *   tournaments: for each tournament CHESS_SNAPSHOT_TOURNAMENT_FIELDS integers: id, max games per player,
+ *                status, winner id, removed players, amount of games, location offset and location length
+ *   locations:   size in bytes, then the locations of all the tournaments, one after another, not terminated
+ *   games:       for each tournament in the order of the table: its player 1 column, player 2 column,
+ *                winner column (uint8_t) and game time column
+ *   checksum:    FNV-1a (uint32_t) of everything before it
+ * the statistics of the players are not saved, since they are restored from the games.
+*/
+#define CHESS_SNAPSHOT_MAGIC "CHSS"
+#define CHESS_SNAPSHOT_MAGIC_SIZE 4
+#define CHESS_SNAPSHOT_VERSION 2
+#define CHESS_SNAPSHOT_TOURNAMENT_FIELDS 8
+#define CHESS_SNAPSHOT_INT_SIZE sizeof(int32_t)
+#define CHESS_SNAPSHOT_GAME_SIZE (3 * CHESS_SNAPSHOT_INT_SIZE + sizeof(uint8_t))
+#define CHESS_SNAPSHOT_CHECKSUM_BASIS 2166136261u
+#define CHESS_SNAPSHOT_CHECKSUM_PRIME 16777619u
+
+/**
+ * The journal layout. it uses the same integers and checksum as the snapshot.
+ *   header:  magic, version, generation
+ *   records: for each successful change of the system, its JournalRecordType (uint8_t), its arguments and the
+ *            checksum of the record. the location of a new tournament is saved as its length and its bytes.
+ * a checkpoint saves a snapshot with the next generation and then starts a new journal of that generation, so a
+ * journal whose generation is older than the snapshot's was already checkpointed.
+*/
+#define CHESS_JOURNAL_MAGIC "CHSJ"
+#define CHESS_JOURNAL_VERSION 1
+#define CHESS_JOURNAL_GROUP_SIZE 64  // records which are flushed together
+
 struct chess_system_t
 {
     Map tournaments_map;
+    Map player_tournaments;  // the PlayerTournament of every player who has games in a tournament
+    Map all_players;  // player id -> struct player_t of every player who has games, over all tournaments
+    Map players_by_level;  // struct player_t of every player in all_players -> his level, ordered by level
+    Map ended_tournaments;  // the id of every tournament which ended, so the statistics visit only them
+    FILE* journal;  // NULL unless journaling
+    char* snapshot_path;
+    char* journal_path;
+    int journal_generation;
+    int journal_pending;  // records written since the last flush
+    bool journal_failed;  // a record could not be written since the last checkpoint
 };
 
+// a player who has games in a tournament. ordered by player first, so the tournaments of a player are a single
+// range of the player_tournaments map.
+typedef struct player_tournament_t {
+    int player_id;
+    int tournament_id;
+} PlayerTournament;
+
+// the records of one tournament in a batch of chessAddGames, chained through next_record.
+typedef struct batch_group_t {
+    size_t first;
+    size_t last;
+} BatchGroup;
+
+typedef enum {
+    JOURNAL_ADD_TOURNAMENT = 1,
+    JOURNAL_ADD_GAME,
+    JOURNAL_REMOVE_TOURNAMENT,
+    JOURNAL_REMOVE_PLAYER,
+    JOURNAL_END_TOURNAMENT
+} JournalRecordType;
+
+// writes a snapshot or a journal record, keeping the checksum of everything written.
+typedef struct snapshot_writer_t {
+    FILE* stream;
+    uint32_t checksum;
+    bool failed;
+} SnapshotWriter;
+
+// reads a snapshot which was read into memory as a whole.
+typedef struct snapshot_reader_t {
+    const unsigned char* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+} SnapshotReader;
+
 // HELPER FUNCTIONS 
 
 /** Function to be used for copying an int as a key to the map */
@@ -29,26 +111,10 @@ static MapKeyElement copyInt(MapKeyElement n) {
     return copy;
 }
 
-/** Function to be used for copying a double as a key to the map */
-static MapKeyElement copyDouble(MapKeyElement n) {
-    if (!n) {
-        return NULL;
-    }
-    double *copy = malloc(sizeof(*copy));
-    if (!copy) {
-        return NULL;
-    }
-    *copy = *(double *) n;
-    return copy;
-}
-
-/** Functions to be used by the map for freeing elements */
+/** Function to be used by the map for freeing elements */
 static void freeInt(MapKeyElement n) {
     free(n);
 }
-static void freeDouble(MapKeyElement n) {
-    free(n);
-}
 
 /** Function to be used by the map for comparing key elements 
  *  @return
@@ -58,6 +124,28 @@ static int compareInt(MapKeyElement key1, MapKeyElement key2) {
     return *(int*)key1 - *(int*)key2;
 }
 
+/** Function to be used by a hash map for hashing int keys */
+static unsigned int hashInt(MapKeyElement key) {
+    return (unsigned int)*(int*)key;
+}
+
+/** Function to be used by the player_tournaments map for comparing PlayerTournament keys, by player and then
+ *  by tournament. compares without subtracting, since the bounds of a player's range are INT_MIN and INT_MAX.
+*/
+static int comparePlayerTournaments(MapKeyElement key1, MapKeyElement key2) {
+    PlayerTournament* first = key1;
+    PlayerTournament* second = key2;
+    if(first->player_id != second->player_id)
+    {
+        return first->player_id < second->player_id ? -1 : 1;
+    }
+    if(first->tournament_id != second->tournament_id)
+    {
+        return first->tournament_id < second->tournament_id ? -1 : 1;
+    }
+    return 0;
+}
+
 /** isValidLocation: checks if the location string is valid as per instructions.
  * @param location - the string to be validated.
  *  @return
@@ -80,32 +168,6 @@ static bool isValidLocation(const char* location)
     return true;
 }
 
-/** Function to be used for comparing two players' score.
- * @param player1 - Player struct of first player to compare.
- * @param player2 - Player struct of seconf player to compare.
- * @return 
- *      positive integer if player1's score is lower than player2's score.
- *      negative integer if player1's score is higher than player2's score.
- *      same score for two players is impossible.**/
-static int comparePlayersScore(Player player1, Player player2)
-{
-    unsigned int player1_score = 2*player1->wins + player1->draws;
-    unsigned int player2_score = 2*player2->wins + player2->draws;
-    if(player1_score == player2_score)
-    {
-        if(player1->losses == player2->losses)
-        {
-            if(player1->wins == player2->wins)
-            {
-                return player1->id - player2->id;  // decide by lowest id
-            }
-            return player2->wins - player1->wins;  // decide by highest amount of wins
-        }
-        return player1->losses - player2->losses;  // decide by lowest amount of losses
-    }
-    return player2_score - player1_score;  // decide by highest score
-}
-
 /** Function to be used for comparing two players' level.
  * @param player1 - Player struct of first player to compare.
  * @param player2 - Player struct of seconf player to compare.
@@ -125,57 +187,688 @@ static int comparePlayersLevel(Player player1, Player player2)
     return (player2_level > player1_level) ? 1 : -1;
 }
 
-/** chessCreateAllPlayersMap: ugly function which creates a map containing all players across all tournaments,
- * with statistics such as wins, losses and draws.
- * @param chess - the chess system.
- * @return 
- *      a NULL if chess is NULL or if an allocation error occured. A Map containing all players across all tournaments
- *      otherwise. **/
-static Map chessCreateAllPlayersMap(ChessSystem chess)
+/** chessReservePlayer: makes sure player_id has an entry in player_tournaments for tournament_id and a record in
+ * all_players, before a game of the player is added. a new record has no games, so it is not in players_by_level.
+ *  @return
+ *      false on memory allocation error, true otherwise.
+*/
+static bool chessReservePlayer(ChessSystem chess, int player_id, int tournament_id)
 {
-    if(chess == NULL)
+    PlayerTournament entry = {player_id, tournament_id};
+    if(mapPut(chess->player_tournaments, &entry, &entry) != MAP_SUCCESS)
     {
+        return false;
+    }
+    if(mapContains(chess->all_players, &player_id))
+    {
+        return true;
+    }
+    struct player_t player = {player_id, 0, 0, 0, 0};
+    return mapPut(chess->all_players, &player_id, &player) == MAP_SUCCESS;
+}
+
+/** chessReleasePlayer: removes the entries chessReservePlayer added, if player_id has no games to keep them for.
+*/
+static void chessReleasePlayer(ChessSystem chess, Tournament tournament, int player_id, int tournament_id)
+{
+    if(tournamentCountGames(tournament, player_id) == 0)
+    {
+        PlayerTournament entry = {player_id, tournament_id};
+        mapRemove(chess->player_tournaments, &entry);
+    }
+    if(getTotalGamesPlayed(mapPeek(chess->all_players, &player_id)) == 0)
+    {
+        mapRemove(chess->all_players, &player_id);
+    }
+}
+
+/** chessPutPlayerLevel: adds new_record to players_by_level. the previous record of the player is not removed, so
+ * this may be done before a change which can fail.
+ *  @return
+ *      false on memory allocation error, true otherwise.
+*/
+static bool chessPutPlayerLevel(ChessSystem chess, Player new_record)
+{
+    double level = playerGetLevel(new_record);
+    return mapPut(chess->players_by_level, new_record, &level) == MAP_SUCCESS;
+}
+
+/** chessRemovePlayerLevel: removes removed_record of a player from players_by_level, unless it has no games (so it
+ * is not there), or it is ordered the same as kept_record, which then uses the same element.
+*/
+static void chessRemovePlayerLevel(ChessSystem chess, Player removed_record, Player kept_record)
+{
+    if(getTotalGamesPlayed(removed_record) == 0)
+    {
+        return;
+    }
+    if(getTotalGamesPlayed(kept_record) == 0 || comparePlayersLevel(removed_record, kept_record) != 0)
+    {
+        mapRemove(chess->players_by_level, removed_record);
+    }
+}
+
+/** chessCommitPlayer: replaces old_record of a player in all_players with new_record, whose level is already in
+ * players_by_level if it has games. a record with no games is removed.
+*/
+static void chessCommitPlayer(ChessSystem chess, Player old_record, Player new_record)
+{
+    chessRemovePlayerLevel(chess, old_record, new_record);
+    if(getTotalGamesPlayed(new_record) == 0)
+    {
+        mapRemove(chess->all_players, &(new_record->id));
+        return;
+    }
+    *(Player)mapGet(chess->all_players, &(new_record->id)) = *new_record;
+}
+
+/** chessReplacePlayer: same as chessCommitPlayer, but also adds the level of new_record. used when a player loses
+ * games or his results change, so he already has a level: it is removed first, and its tree node is reused by
+ * the new level, so this can not fail.
+*/
+static void chessReplacePlayer(ChessSystem chess, Player old_record, Player new_record)
+{
+    chessRemovePlayerLevel(chess, old_record, new_record);
+    if(getTotalGamesPlayed(new_record) > 0)
+    {
+        chessPutPlayerLevel(chess, new_record);
+    }
+    chessCommitPlayer(chess, new_record, new_record);
+}
+
+/** chessGiveWinToOpponent: called by tournamentRemovePlayer when opponent_id gets the win of a game he lost, or
+ * drew if was_draw is true.
+*/
+static void chessGiveWinToOpponent(void* chess, int opponent_id, bool was_draw)
+{
+    struct player_t old_record = *(Player)mapPeek(((ChessSystem)chess)->all_players, &opponent_id);
+    struct player_t new_record = old_record;
+    new_record.draws -= was_draw;
+    new_record.losses -= !was_draw;
+    new_record.wins++;
+    chessReplacePlayer(chess, &old_record, &new_record);
+}
+/** chessCreateTempPath: returns path_file with CHESS_TEMP_FILE_SUFFIX appended, which the caller frees, or NULL
+ * on memory allocation error.
+*/
+static char* chessCreateTempPath(const char* path_file)
+{
+    char* temp_path = malloc(strlen(path_file) + strlen(CHESS_TEMP_FILE_SUFFIX) + 1);
+    if(temp_path == NULL)
+    {
+        return NULL;
+    }
+    strcpy(temp_path, path_file);
+    strcat(temp_path, CHESS_TEMP_FILE_SUFFIX);
+    return temp_path;
+}
+
+/** snapshotChecksum: continues the FNV-1a checksum of a snapshot over size more bytes.
+*/
+static uint32_t snapshotChecksum(uint32_t checksum, const void* data, size_t size)
+{
+    const unsigned char* bytes = data;
+    for(size_t i = 0; i < size; i++)
+    {
+        checksum = (checksum ^ bytes[i]) * CHESS_SNAPSHOT_CHECKSUM_PRIME;
+    }
+    return checksum;
+}
+
+static void snapshotWrite(SnapshotWriter* writer, const void* data, size_t size)
+{
+    if(writer->failed || size == 0)
+    {
+        return;
+    }
+    writer->checksum = snapshotChecksum(writer->checksum, data, size);
+    if(fwrite(data, 1, size, writer->stream) != size)
+    {
+        writer->failed = true;
+    }
+}
+
+static void snapshotWriteInt(SnapshotWriter* writer, int value)
+{
+    int32_t fixed_value = value;
+    snapshotWrite(writer, &fixed_value, sizeof(fixed_value));
+}
+
+/** snapshotWriteGames: writes the games of a tournament, one column after the other.
+*/
+static void snapshotWriteGames(SnapshotWriter* writer, Games games)
+{
+    int games_count = gamesGetCount(games);
+    for(int i = 0; i < games_count; i++)
+    {
+        struct game_t game = gamesGet(games, i);
+        snapshotWriteInt(writer, getPlayer1ID(&game));
+    }
+    for(int i = 0; i < games_count; i++)
+    {
+        struct game_t game = gamesGet(games, i);
+        snapshotWriteInt(writer, getPlayer2ID(&game));
+    }
+    for(int i = 0; i < games_count; i++)
+    {
+        struct game_t game = gamesGet(games, i);
+        uint8_t winner = getWinner(&game);
+        snapshotWrite(writer, &winner, sizeof(winner));
+    }
+    for(int i = 0; i < games_count; i++)
+    {
+        struct game_t game = gamesGet(games, i);
+        snapshotWriteInt(writer, getGameTime(&game));
+    }
+}
+
+/** snapshotReadBytes: returns the next size bytes of the snapshot (NOT a copy), or NULL if it is too short.
+*/
+static const unsigned char* snapshotReadBytes(SnapshotReader* reader, size_t size)
+{
+    if(reader->failed || size > reader->size - reader->offset)
+    {
+        reader->failed = true;
         return NULL;
     }
-    Map all_players = mapCreate((copyMapDataElements)playerCopy, copyInt, 
-                                (freeMapDataElements)playerDestroy, freeInt, compareInt);
-    if(all_players == NULL)
+    const unsigned char* bytes = reader->data + reader->offset;
+    reader->offset += size;
+    return bytes;
+}
+
+// returns the index-th integer of a column of the snapshot.
+static int snapshotIntAt(const unsigned char* column, int index)
+{
+    int32_t value;
+    memcpy(&value, column + (size_t)index * CHESS_SNAPSHOT_INT_SIZE, sizeof(value));
+    return value;
+}
+
+static int snapshotReadInt(SnapshotReader* reader)
+{
+    const unsigned char* bytes = snapshotReadBytes(reader, CHESS_SNAPSHOT_INT_SIZE);
+    return bytes == NULL ? 0 : snapshotIntAt(bytes, 0);
+}
+
+/** snapshotReadFile: reads the whole file at path_file into memory, which the caller frees.
+ *  @return
+ *      CHESS_LOAD_FAILURE if the file could not be read, CHESS_OUT_OF_MEMORY on memory allocation error and
+ *      CHESS_SUCCESS otherwise.
+*/
+static ChessResult snapshotReadFile(const char* path_file, unsigned char** data, size_t* size)
+{
+    FILE* stream = fopen(path_file, "rb");
+    if(stream == NULL)
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    long file_size = -1;
+    if(fseek(stream, 0, SEEK_END) == 0)
+    {
+        file_size = ftell(stream);
+    }
+    if(file_size < 0 || fseek(stream, 0, SEEK_SET) != 0)
+    {
+        fclose(stream);
+        return CHESS_LOAD_FAILURE;
+    }
+    *data = malloc(file_size > 0 ? (size_t)file_size : 1);
+    if(*data == NULL)
+    {
+        fclose(stream);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    *size = fread(*data, 1, (size_t)file_size, stream);
+    fclose(stream);
+    if(*size != (size_t)file_size)
+    {
+        free(*data);
+        return CHESS_LOAD_FAILURE;
+    }
+    return CHESS_SUCCESS;
+}
+
+/** isValidSnapshotGame: checks if a game of a snapshot could have been added by chessAddGame, and then had
+ * its players removed.
+*/
+static bool isValidSnapshotGame(int first_player, int second_player, int winner, int play_time)
+{
+    if((first_player <= 0 && first_player != PLAYER_REMOVED) || (second_player <= 0 && second_player != PLAYER_REMOVED))
+    {
+        return false;
+    }
+    if(first_player == second_player && first_player != PLAYER_REMOVED)
+    {
+        return false;
+    }
+    return (winner == FIRST_PLAYER || winner == SECOND_PLAYER || winner == DRAW) && play_time >= 0;
+}
+
+/** chessIndexTournament: adds the players of a restored tournament to player_tournaments and adds their results
+ * to all_players. returns false on memory allocation error.
+*/
+static bool chessIndexTournament(ChessSystem chess, int tournament_id, Tournament tournament)
+{
+    for(MapIterator player_iterator = mapIterBeginUnordered(getTournamentPlayersMap(tournament));
+        mapIterKey(&player_iterator); mapIterNext(&player_iterator))
+    {
+        Player player = mapIterPeek(&player_iterator);
+        if(!chessReservePlayer(chess, player->id, tournament_id))
+        {
+            return false;
+        }
+        Player player_all = mapGet(chess->all_players, &(player->id));
+        player_all->wins += player->wins;
+        player_all->losses += player->losses;
+        player_all->draws += player->draws;
+        player_all->play_time += player->play_time;
+    }
+    return true;
+}
+
+/** chessRestoreTournament: adds a tournament of a snapshot, whose table entry is entry, to the system.
+ *  @return
+ *      CHESS_LOAD_FAILURE if the tournament is not valid, CHESS_OUT_OF_MEMORY on memory allocation error and
+ *      CHESS_SUCCESS otherwise.
+*/
+static ChessResult chessRestoreTournament(ChessSystem chess, SnapshotReader* reader, const unsigned char* entry,
+                                          const char* locations, int locations_size)
+{
+    int tournament_id = snapshotIntAt(entry, 0);
+    int max_games = snapshotIntAt(entry, 1);
+    int status = snapshotIntAt(entry, 2);
+    int winner_id = snapshotIntAt(entry, 3);
+    int removed_players = snapshotIntAt(entry, 4);
+    int games_count = snapshotIntAt(entry, 5);
+    int location_offset = snapshotIntAt(entry, 6);
+    int location_length = snapshotIntAt(entry, 7);
+    if((status != IN_PROCCESS && status != DONE) || removed_players < 0 || games_count < 0 ||
+       location_offset < 0 || location_length < 0 || location_length > locations_size - location_offset)
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    const unsigned char* games = snapshotReadBytes(reader, (size_t)games_count * CHESS_SNAPSHOT_GAME_SIZE);
+    if(games == NULL)
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    char* location = malloc(location_length + 1);
+    if(location == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    memcpy(location, locations + location_offset, location_length);
+    location[location_length] = '\0';
+    ChessResult result = chessAddTournament(chess, tournament_id, max_games, location);
+    free(location);
+    if(result != CHESS_SUCCESS)  // the id, the location or the max games are not valid
+    {
+        return result == CHESS_OUT_OF_MEMORY ? CHESS_OUT_OF_MEMORY : CHESS_LOAD_FAILURE;
+    }
+
+    Tournament tournament = mapGet(chess->tournaments_map, &tournament_id);
+    const unsigned char* first_players = games;
+    const unsigned char* second_players = first_players + (size_t)games_count * CHESS_SNAPSHOT_INT_SIZE;
+    const unsigned char* winners = second_players + (size_t)games_count * CHESS_SNAPSHOT_INT_SIZE;
+    const unsigned char* play_times = winners + (size_t)games_count * sizeof(uint8_t);
+    for(int i = 0; i < games_count; i++)
+    {
+        int first_player = snapshotIntAt(first_players, i);
+        int second_player = snapshotIntAt(second_players, i);
+        int play_time = snapshotIntAt(play_times, i);
+        if(!isValidSnapshotGame(first_player, second_player, winners[i], play_time))
+        {
+            return CHESS_LOAD_FAILURE;
+        }
+        if(tournamentAddGame(tournament, first_player, second_player, winners[i], play_time) != TOURNAMENT_SUCCESS)
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    setTournamentRemovedPlayers(tournament, removed_players);
+    setTournamentWinnerID(tournament, winner_id);
+    if(status == DONE && mapPut(chess->ended_tournaments, &tournament_id, &tournament_id) != MAP_SUCCESS)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    setTournamentStatus(tournament, status);
+    return chessIndexTournament(chess, tournament_id, tournament) ? CHESS_SUCCESS : CHESS_OUT_OF_MEMORY;
+}
+
+/** chessRestoreSnapshot: adds all the tournaments of a snapshot whose header was already read to an empty system.
+ *  @return
+ *      CHESS_LOAD_FAILURE if the snapshot is not valid, CHESS_OUT_OF_MEMORY on memory allocation error and
+ *      CHESS_SUCCESS otherwise.
+*/
+static ChessResult chessRestoreSnapshot(ChessSystem chess, SnapshotReader* reader)
+{
+    int tournaments_count = snapshotReadInt(reader);
+    const unsigned char* table = NULL;
+    if(tournaments_count >= 0)
+    {
+        table = snapshotReadBytes(reader, (size_t)tournaments_count * CHESS_SNAPSHOT_TOURNAMENT_FIELDS *
+                                          CHESS_SNAPSHOT_INT_SIZE);
+    }
+    int locations_size = snapshotReadInt(reader);
+    const unsigned char* locations = NULL;
+    if(locations_size >= 0)
+    {
+        locations = snapshotReadBytes(reader, locations_size);
+    }
+    if(table == NULL || locations == NULL)
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    for(int i = 0; i < tournaments_count; i++)
+    {
+        const unsigned char* entry = table + (size_t)i * CHESS_SNAPSHOT_TOURNAMENT_FIELDS * CHESS_SNAPSHOT_INT_SIZE;
+        ChessResult result = chessRestoreTournament(chess, reader, entry, (const char*)locations, locations_size);
+        if(result != CHESS_SUCCESS)
+        {
+            return result;
+        }
+    }
+    if(reader->offset != reader->size)  // bytes after the last games
+    {
+        return CHESS_LOAD_FAILURE;
+    }
+    // the levels are added once all the results of every player are known, in any order.
+    for(MapIterator player_iterator = mapIterBeginUnordered(chess->all_players); mapIterKey(&player_iterator);
+        mapIterNext(&player_iterator))
+    {
+        if(!chessPutPlayerLevel(chess, mapIterPeek(&player_iterator)))
+        {
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+/** chessJournalBegin: starts a journal record of the given type, if the system is journaling.
+ *  @return
+ *      true if the arguments of the record should be written to record and then ended by chessJournalEnd.
+*/
+static bool chessJournalBegin(ChessSystem chess, SnapshotWriter* record, JournalRecordType type)
+{
+    if(chess->snapshot_path == NULL)  // not journaling
+    {
+        return false;
+    }
+    if(chess->journal == NULL)  // the last checkpoint could not start a journal
+    {
+        chess->journal_failed = true;
+        return false;
+    }
+    record->stream = chess->journal;
+    record->checksum = CHESS_SNAPSHOT_CHECKSUM_BASIS;
+    record->failed = false;
+    uint8_t record_type = type;
+    snapshotWrite(record, &record_type, sizeof(record_type));
+    return true;
+}
+
+/** chessJournalEnd: ends a journal record with its checksum. the records are flushed in groups of
+ * CHESS_JOURNAL_GROUP_SIZE, so every change does not wait for its own write.
+*/
+static void chessJournalEnd(ChessSystem chess, SnapshotWriter* record)
+{
+    uint32_t checksum = record->checksum;
+    snapshotWrite(record, &checksum, sizeof(checksum));
+    chess->journal_pending++;
+    if(chess->journal_pending == CHESS_JOURNAL_GROUP_SIZE)
+    {
+        if(fflush(chess->journal) != 0)
+        {
+            record->failed = true;
+        }
+        chess->journal_pending = 0;
+    }
+    if(record->failed)
+    {
+        chess->journal_failed = true;
+    }
+}
+
+// returns the amount of integers saved for a journal record of the given type, or 0 if there is no such type.
+static int journalArgumentsCount(int type)
+{
+    switch(type)
+    {
+        case JOURNAL_ADD_TOURNAMENT:
+            return 3;  // id, max games per player and the length of the location
+        case JOURNAL_ADD_GAME:
+            return 5;
+        case JOURNAL_REMOVE_TOURNAMENT:
+        case JOURNAL_REMOVE_PLAYER:
+        case JOURNAL_END_TOURNAMENT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/** chessApplyJournalRecord: makes the change a journal record was written for, by calling the same function.
+*/
+static ChessResult chessApplyJournalRecord(ChessSystem chess, int type, const int* arguments,
+                                           const unsigned char* location)
+{
+    switch(type)
+    {
+        case JOURNAL_ADD_TOURNAMENT:
+        {
+            char* location_string = malloc(arguments[2] + 1);
+            if(location_string == NULL)
+            {
+                return CHESS_OUT_OF_MEMORY;
+            }
+            memcpy(location_string, location, arguments[2]);
+            location_string[arguments[2]] = '\0';
+            ChessResult result = chessAddTournament(chess, arguments[0], arguments[1], location_string);
+            free(location_string);
+            return result;
+        }
+        case JOURNAL_ADD_GAME:
+            return chessAddGame(chess, arguments[0], arguments[1], arguments[2], arguments[3], arguments[4]);
+        case JOURNAL_REMOVE_TOURNAMENT:
+            return chessRemoveTournament(chess, arguments[0]);
+        case JOURNAL_REMOVE_PLAYER:
+            return chessRemovePlayer(chess, arguments[0]);
+        default:
+            return chessEndTournament(chess, arguments[0]);
+    }
+}
+
+/** chessReplayJournalRecords: makes the changes of the records of a journal whose header was already read.
+ * the records end at the first record which is incomplete or whose checksum is wrong, since it is the record
+ * which was being written when the journal stopped.
+ *  @return
+ *      CHESS_LOAD_FAILURE if a record could not be replayed, meaning the journal does not belong to the
+ *      system, CHESS_OUT_OF_MEMORY on memory allocation error and CHESS_SUCCESS otherwise.
+*/
+static ChessResult chessReplayJournalRecords(ChessSystem chess, SnapshotReader* reader)
+{
+    while(reader->offset < reader->size)
+    {
+        size_t record_start = reader->offset;
+        const unsigned char* type = snapshotReadBytes(reader, sizeof(uint8_t));
+        int arguments_count = type == NULL ? 0 : journalArgumentsCount(*type);
+        int arguments[5] = {0};
+        for(int i = 0; i < arguments_count; i++)
+        {
+            arguments[i] = snapshotReadInt(reader);
+        }
+        const unsigned char* location = NULL;
+        if(arguments_count > 0 && *type == JOURNAL_ADD_TOURNAMENT)
+        {
+            reader->failed = reader->failed || arguments[2] < 0;
+            location = snapshotReadBytes(reader, arguments[2]);
+        }
+        uint32_t checksum = snapshotChecksum(CHESS_SNAPSHOT_CHECKSUM_BASIS, reader->data + record_start,
+                                             reader->offset - record_start);
+        const unsigned char* saved_checksum = snapshotReadBytes(reader, sizeof(checksum));
+        if(arguments_count == 0 || reader->failed || memcmp(saved_checksum, &checksum, sizeof(checksum)) != 0)
+        {
+            return CHESS_SUCCESS;
+        }
+        ChessResult result = chessApplyJournalRecord(chess, *type, arguments, location);
+        if(result != CHESS_SUCCESS)
+        {
+            return result == CHESS_OUT_OF_MEMORY ? CHESS_OUT_OF_MEMORY : CHESS_LOAD_FAILURE;
+        }
+    }
+    return CHESS_SUCCESS;
+}
+
+/** chessReplayJournal: makes the changes of the journal at path_file, if it was not checkpointed yet.
+ *  @return
+ *      CHESS_LOAD_FAILURE if the journal could not be read or does not belong to the system,
+ *      CHESS_OUT_OF_MEMORY on memory allocation error and CHESS_SUCCESS otherwise.
+*/
+static ChessResult chessReplayJournal(ChessSystem chess, const char* path_file)
+{
+    unsigned char* data = NULL;
+    size_t size = 0;
+    ChessResult result = snapshotReadFile(path_file, &data, &size);
+    if(result != CHESS_SUCCESS)
+    {
+        return result;
+    }
+    SnapshotReader reader = {data, size, 0, false};
+    const unsigned char* magic = snapshotReadBytes(&reader, CHESS_SNAPSHOT_MAGIC_SIZE);
+    int version = snapshotReadInt(&reader);
+    int generation = snapshotReadInt(&reader);
+    if(reader.failed || generation < chess->journal_generation)
+    {
+        // the checkpoint which started the journal stopped before writing its header, or finished the journal.
+        result = CHESS_SUCCESS;
+    }
+    else if(memcmp(magic, CHESS_JOURNAL_MAGIC, CHESS_SNAPSHOT_MAGIC_SIZE) != 0 ||
+            version != CHESS_JOURNAL_VERSION || generation > chess->journal_generation)
+    {
+        result = CHESS_LOAD_FAILURE;
+    }
+    else
+    {
+        result = chessReplayJournalRecords(chess, &reader);
+    }
+    free(data);
+    return result;
+}
+
+/** chessStartJournal: starts a new empty journal of the current generation at journal_path.
+ *  @return
+ *      CHESS_SAVE_FAILURE if the journal could not be written and CHESS_SUCCESS otherwise.
+*/
+static ChessResult chessStartJournal(ChessSystem chess)
+{
+    if(chess->journal != NULL)
+    {
+        fclose(chess->journal);
+    }
+    chess->journal_pending = 0;
+    chess->journal = fopen(chess->journal_path, "wb");
+    if(chess->journal == NULL)
+    {
+        chess->journal_failed = true;
+        return CHESS_SAVE_FAILURE;
+    }
+    setvbuf(chess->journal, NULL, _IOFBF, CHESS_SAVE_BUFFER_SIZE);
+    SnapshotWriter header = {chess->journal, CHESS_SNAPSHOT_CHECKSUM_BASIS, false};
+    snapshotWrite(&header, CHESS_JOURNAL_MAGIC, CHESS_SNAPSHOT_MAGIC_SIZE);
+    snapshotWriteInt(&header, CHESS_JOURNAL_VERSION);
+    snapshotWriteInt(&header, chess->journal_generation);
+    chess->journal_failed = header.failed || fflush(chess->journal) != 0;
+    return chess->journal_failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+// returns a copy of string, or NULL on memory allocation error.
+static char* copyString(const char* string)
+{
+    char* copy = malloc(strlen(string) + 1);
+    if(copy != NULL)
+    {
+        strcpy(copy, string);
+    }
+    return copy;
+}
+
+/** chessAddTournamentGame: adds a game to a tournament which was already looked up, as chessAddGame does once
+ * the ids are checked. tournament is NULL if there is no tournament with tournament_id.
+*/
+static ChessResult chessAddTournamentGame(ChessSystem chess, int tournament_id, Tournament tournament,
+                                          int first_player, int second_player, Winner winner, int play_time)
+{
+    if(tournament == NULL)
+    {
+        return CHESS_TOURNAMENT_NOT_EXIST;
+    }
+    if(getTournamentStatus(tournament) == DONE)
+    {
+        return CHESS_TOURNAMENT_ENDED;
+    }
+    if(doesGameExist(tournament, first_player, second_player) == true)
+    {
+        return CHESS_GAME_ALREADY_EXISTS;
+    }
+    if(play_time < 0)
+    {
+        return CHESS_INVALID_PLAY_TIME;
+    }
+    int max_games = getTournamentMaxGamesAllowed(tournament);
+    if(tournamentCountGames(tournament, first_player) == max_games || 
+       tournamentCountGames(tournament, second_player) == max_games)
+    {
+        return CHESS_EXCEEDED_GAMES;
+    }
+
+    if(!chessReservePlayer(chess, first_player, tournament_id) ||
+       !chessReservePlayer(chess, second_player, tournament_id))
+    {
+        chessReleasePlayer(chess, tournament, first_player, tournament_id);
+        chessReleasePlayer(chess, tournament, second_player, tournament_id);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    // the new levels of the players are added before the game, and the old ones are removed once it is added.
+    struct player_t first_record = *(Player)mapPeek(chess->all_players, &first_player);
+    struct player_t second_record = *(Player)mapPeek(chess->all_players, &second_player);
+    struct player_t new_first_record = first_record;
+    struct player_t new_second_record = second_record;
+    new_first_record.wins += (winner == FIRST_PLAYER);
+    new_first_record.losses += (winner == SECOND_PLAYER);
+    new_first_record.draws += (winner == DRAW);
+    new_first_record.play_time += play_time;
+    new_second_record.wins += (winner == SECOND_PLAYER);
+    new_second_record.losses += (winner == FIRST_PLAYER);
+    new_second_record.draws += (winner == DRAW);
+    new_second_record.play_time += play_time;
+    TournamentError result = TOURNAMENT_OUT_OF_MEMORY;
+    if(chessPutPlayerLevel(chess, &new_first_record) && chessPutPlayerLevel(chess, &new_second_record))
+    {
+        result = tournamentAddGame(tournament, first_player, second_player, winner, play_time);
+    }
+    if(result == TOURNAMENT_OUT_OF_MEMORY)
     {
-        return NULL;
+        chessRemovePlayerLevel(chess, &new_first_record, &first_record);
+        chessRemovePlayerLevel(chess, &new_second_record, &second_record);
+        chessReleasePlayer(chess, tournament, first_player, tournament_id);
+        chessReleasePlayer(chess, tournament, second_player, tournament_id);
+        return CHESS_OUT_OF_MEMORY;
     }
-    MAP_FOREACH(int*, tournament_id, chess->tournaments_map)
+    chessCommitPlayer(chess, &first_record, &new_first_record);
+    chessCommitPlayer(chess, &second_record, &new_second_record);
+
+    SnapshotWriter record;
+    if(chessJournalBegin(chess, &record, JOURNAL_ADD_GAME))
     {
-        Tournament tournament = mapGet(chess->tournaments_map, tournament_id);
-        List players_iterator = getTournamentPlayersList(tournament);
-        while(players_iterator)
-        {
-            Player player_tournament = listGetData(players_iterator);
-            if(player_tournament == NULL)  // no players in tournament
-            {
-                break;  // end while, go to next tournament
-            }
-            Player player_all = mapGet(all_players, &(player_tournament->id));
-            if(player_all == NULL)  // add player to the map.
-            {
-                if(mapPut(all_players, &(player_tournament->id), player_tournament) == MAP_OUT_OF_MEMORY)
-                {
-                    freeInt(tournament_id);
-                    mapDestroy(all_players);
-                    return NULL;
-                }
-            }
-            else  // player already exists in map, update his values.
-            {
-                player_all->wins += player_tournament->wins;
-                player_all->losses += player_tournament->losses;
-                player_all->draws += player_tournament->draws;
-            }
-            players_iterator = players_iterator->next;
-        }
-        freeInt(tournament_id);
+        snapshotWriteInt(&record, tournament_id);
+        snapshotWriteInt(&record, first_player);
+        snapshotWriteInt(&record, second_player);
+        snapshotWriteInt(&record, winner);
+        snapshotWriteInt(&record, play_time);
+        chessJournalEnd(chess, &record);
     }
-    return all_players;
+    return CHESS_SUCCESS;
 }
+
 // HELPER FUNCTIONS END
 
 // IMPLEMENTATION STARTS HERE
@@ -186,15 +879,48 @@ ChessSystem chessCreate()
     {
         return NULL;
     }
+    chess->player_tournaments = NULL;
+    chess->all_players = NULL;
+    chess->players_by_level = NULL;
+    chess->ended_tournaments = NULL;
+    chess->journal = NULL;
+    chess->snapshot_path = NULL;
+    chess->journal_path = NULL;
+    chess->journal_generation = 0;
+    chess->journal_pending = 0;
+    chess->journal_failed = false;
 
-    chess->tournaments_map = mapCreate((copyMapDataElements)tournamentCopy, copyInt, 
-                                       (freeMapDataElements)tournamentDestroy, freeInt, compareInt);
+    chess->tournaments_map = mapCreateHash((copyMapDataElements)tournamentCopy, copyInt, 
+                                           (freeMapDataElements)tournamentDestroy, freeInt, compareInt, hashInt);
     if(chess->tournaments_map == NULL)
     {
         chessDestroy(chess);
         return NULL;
         
     }
+    // a set of PlayerTournament, so the map holds no data.
+    chess->player_tournaments = mapCreateInline(sizeof(PlayerTournament), 0, comparePlayerTournaments);
+    if(chess->player_tournaments == NULL)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    // players are small structs without pointers, so they are stored inside the maps.
+    chess->all_players = mapCreateInlineHash(sizeof(int), sizeof(struct player_t), compareInt, hashInt);
+    chess->players_by_level = mapCreateInline(sizeof(struct player_t), sizeof(double),
+                                              (compareMapKeyElements)comparePlayersLevel);
+    if(chess->all_players == NULL || chess->players_by_level == NULL)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    // a set of ids, ordered so the statistics are written by tournament id.
+    chess->ended_tournaments = mapCreateInline(sizeof(int), 0, compareInt);
+    if(chess->ended_tournaments == NULL)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
 
     return chess;
 }
@@ -205,7 +931,12 @@ void chessDestroy(ChessSystem chess)
     {
         return;
     }
+    chessCloseJournal(chess);
     mapDestroy(chess->tournaments_map);
+    mapDestroy(chess->player_tournaments);
+    mapDestroy(chess->all_players);
+    mapDestroy(chess->players_by_level);
+    mapDestroy(chess->ended_tournaments);
     free(chess);
 }
 
@@ -238,13 +969,25 @@ ChessResult chessAddTournament(ChessSystem chess, int tournament_id,  // unsigne
     {
         return CHESS_OUT_OF_MEMORY;
     }
-    MapResult result = mapPut(chess->tournaments_map, &tournament_id, new_tournament);
-    tournamentDestroy(new_tournament);
-    if(result == MAP_OUT_OF_MEMORY)
+    // the map takes the new tournament and key, so the tournament is not deep copied.
+    int* tournament_key = copyInt(&tournament_id);
+    if(tournament_key == NULL || mapPutTake(chess->tournaments_map, tournament_key, new_tournament) != MAP_SUCCESS)
     {
+        freeInt(tournament_key);
+        tournamentDestroy(new_tournament);
         return CHESS_OUT_OF_MEMORY;
     }
 
+    SnapshotWriter record;
+    if(chessJournalBegin(chess, &record, JOURNAL_ADD_TOURNAMENT))
+    {
+        int location_length = strlen(tournament_location);
+        snapshotWriteInt(&record, tournament_id);
+        snapshotWriteInt(&record, max_games_per_player);
+        snapshotWriteInt(&record, location_length);
+        snapshotWrite(&record, tournament_location, location_length);
+        chessJournalEnd(chess, &record);
+    }
     return CHESS_SUCCESS;
 }
 
@@ -259,38 +1002,8 @@ ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
     {
         return CHESS_INVALID_ID;
     }
-    if(mapContains(chess->tournaments_map, &tournament_id) == false)
-    {
-        return CHESS_TOURNAMENT_NOT_EXIST;
-    }
-
-    Tournament tournament = mapGet(chess->tournaments_map, &tournament_id);
-    if(getTournamentStatus(tournament) == DONE)
-    {
-        return CHESS_TOURNAMENT_ENDED;
-    }
-    if(doesGameExist(tournament, first_player, second_player) == true)
-    {
-        return CHESS_GAME_ALREADY_EXISTS;
-    }
-    if(play_time < 0)
-    {
-        return CHESS_INVALID_PLAY_TIME;
-    }
-    int max_games = getTournamentMaxGamesAllowed(tournament);
-    if(tournamentCountGames(tournament, first_player) == max_games || 
-       tournamentCountGames(tournament, second_player) == max_games)
-    {
-        return CHESS_EXCEEDED_GAMES;
-    }
-
-    TournamentError result = tournamentAddGame(tournament, first_player, second_player, winner, play_time);
-    if(result == TOURNAMENT_OUT_OF_MEMORY)
-    {
-        return CHESS_OUT_OF_MEMORY;
-    }
-    
-    return CHESS_SUCCESS;
+    return chessAddTournamentGame(chess, tournament_id, mapGet(chess->tournaments_map, &tournament_id),
+                                  first_player, second_player, winner, play_time);
 }
 
 ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
@@ -309,7 +1022,33 @@ ChessResult chessRemoveTournament(ChessSystem chess, int tournament_id)
         return CHESS_TOURNAMENT_NOT_EXIST;
     }
 
+    // the players of the tournament are exactly the players who have an entry for it. they are walked in no
+    // particular order, which unlike a sorted walk can not fail.
+    Tournament tournament = mapPeek(chess->tournaments_map, &tournament_id);
+    Map players = getTournamentPlayersMap(tournament);
+    for(MapIterator player_iterator = mapIterBeginUnordered(players); mapIterKey(&player_iterator);
+        mapIterNext(&player_iterator))
+    {
+        Player player = mapIterPeek(&player_iterator);
+        PlayerTournament entry = {player->id, tournament_id};
+        mapRemove(chess->player_tournaments, &entry);
+        struct player_t old_record = *(Player)mapPeek(chess->all_players, &(player->id));
+        struct player_t new_record = old_record;
+        new_record.wins -= player->wins;
+        new_record.losses -= player->losses;
+        new_record.draws -= player->draws;
+        new_record.play_time -= player->play_time;
+        chessReplacePlayer(chess, &old_record, &new_record);
+    }
     mapRemove(chess->tournaments_map, &tournament_id);
+    mapRemove(chess->ended_tournaments, &tournament_id);
+
+    SnapshotWriter record;
+    if(chessJournalBegin(chess, &record, JOURNAL_REMOVE_TOURNAMENT))
+    {
+        snapshotWriteInt(&record, tournament_id);
+        chessJournalEnd(chess, &record);
+    }
     return CHESS_SUCCESS;
 }
 
@@ -323,17 +1062,34 @@ ChessResult chessRemovePlayer(ChessSystem chess, int player_id)
     {
         return CHESS_INVALID_ID;
     }
-    int instances_removed = 0;
-
-    MAP_FOREACH(int*, tournament_id, chess->tournaments_map)
+    // only the tournaments the player has games in are visited. each entry is removed once its tournament is
+    // updated, so the first entry of the player is sought again.
+    PlayerTournament first_entry = {player_id, INT_MIN};
+    MapIterator entry_iterator = mapLowerBound(chess->player_tournaments, &first_entry);
+    PlayerTournament* entry = mapIterKey(&entry_iterator);
+    if(entry == NULL || entry->player_id != player_id)
     {
-        Tournament tournament_iterator = mapGet(chess->tournaments_map, tournament_id);
-        instances_removed += tournamentRemovePlayer(tournament_iterator, player_id);
-        freeInt(tournament_id);
+        return CHESS_PLAYER_NOT_EXIST;
     }
-    if(instances_removed == 0) // not a very good approach
+    while(entry != NULL && entry->player_id == player_id)
     {
-        return CHESS_PLAYER_NOT_EXIST;
+        PlayerTournament removed_entry = *entry;
+        tournamentRemovePlayer(mapGet(chess->tournaments_map, &removed_entry.tournament_id), player_id,
+                               chessGiveWinToOpponent, chess);
+        mapRemove(chess->player_tournaments, &removed_entry);
+        entry_iterator = mapLowerBound(chess->player_tournaments, &first_entry);
+        entry = mapIterKey(&entry_iterator);
+    }
+    // the removed player has no games left.
+    struct player_t old_record = *(Player)mapPeek(chess->all_players, &player_id);
+    struct player_t new_record = {player_id, 0, 0, 0, 0};
+    chessReplacePlayer(chess, &old_record, &new_record);
+
+    SnapshotWriter record;
+    if(chessJournalBegin(chess, &record, JOURNAL_REMOVE_PLAYER))
+    {
+        snapshotWriteInt(&record, player_id);
+        chessJournalEnd(chess, &record);
     }
     return CHESS_SUCCESS;
 }
@@ -363,27 +1119,24 @@ ChessResult chessEndTournament(ChessSystem chess, int tournament_id)
         return CHESS_NO_GAMES;
     }
 
-    List players_iterator = getTournamentPlayersList(tournament);
-    
-    if(listGetData(players_iterator) == NULL) // // no players in tournament
+    if(mapPut(chess->ended_tournaments, &tournament_id, &tournament_id) != MAP_SUCCESS)
     {
-        setTournamentStatus(tournament, DONE);
-        return CHESS_SUCCESS;  // or CHESS_NULL_ARGUMENT? either way it won't be checked
+        return CHESS_OUT_OF_MEMORY;
     }
-    Map players_score = mapCreate(copyInt, (copyMapKeyElements)playerCopy, freeInt, 
-                                 (freeMapKeyElements)playerDestroy, (compareMapKeyElements)comparePlayersScore);
-    while(players_iterator)
+    Player winner = tournamentGetLeader(tournament);
+    
+    if(winner != NULL) // no players in tournament otherwise
     {
-        Player player = listGetData(players_iterator);
-        mapPut(players_score, player, &(player->id));
-        players_iterator = players_iterator->next;
+        setTournamentWinnerID(tournament, winner->id);  // before the standings are cleared
     }
-
     setTournamentStatus(tournament, DONE);
-    int* winner_id = mapGetFirst(players_score);
-    setTournamentWinnerID(tournament, *winner_id);
-    freeInt(winner_id);  // mapGetFirst returns a copy of Player
-    mapDestroy(players_score);
+
+    SnapshotWriter record;
+    if(chessJournalBegin(chess, &record, JOURNAL_END_TOURNAMENT))
+    {
+        snapshotWriteInt(&record, tournament_id);
+        chessJournalEnd(chess, &record);
+    }
     return CHESS_SUCCESS;
 }
 
@@ -399,22 +1152,14 @@ double chessCalculateAveragePlayTime (ChessSystem chess, int player_id, ChessRes
         *chess_result = CHESS_INVALID_ID;
         return 0;
     }
-    // need to return CHESS_PLAYER_NOT_EXIST
-    int total_play_time = 0, total_games_played = 0;
-    MAP_FOREACH(int*, tournament_iterator, chess->tournaments_map)
-    {
-        Tournament tournament = mapGet(chess->tournaments_map, tournament_iterator);
-        total_play_time += tournamentCalculateGameTime(tournament, player_id);
-        total_games_played += tournamentCountGames(tournament, player_id);
-        freeInt(tournament_iterator);
-    }
-    if(total_games_played == 0)  // did not appear in any games
+    Player player = mapPeek(chess->all_players, &player_id);
+    if(player == NULL)  // did not appear in any games
     {
         *chess_result = CHESS_PLAYER_NOT_EXIST;
         return 0;
     }
     *chess_result = CHESS_SUCCESS;
-    return (double)total_play_time/(double)total_games_played;
+    return (double)player->play_time/(double)getTotalGamesPlayed(player);
 }
 
 ChessResult chessSavePlayersLevels(ChessSystem chess, FILE* file)
@@ -424,84 +1169,412 @@ ChessResult chessSavePlayersLevels(ChessSystem chess, FILE* file)
         return CHESS_NULL_ARGUMENT;
     }
 
-    Map all_players = chessCreateAllPlayersMap(chess);
-    if(all_players == NULL)
+    // the levels are kept ordered as games are added and removed, so they are only written here.
+    MAP_ITER_FOREACH(level_iterator, chess->players_by_level)
     {
-        return CHESS_OUT_OF_MEMORY;
+        Player player = mapIterKey(&level_iterator);
+        double* level = mapIterPeek(&level_iterator);
+        int result = fprintf(file, "%d %.2f\n", (int)player->id, (double)*level);
+        if(result <= 0)  // error while writing
+        {
+            return CHESS_SAVE_FAILURE;
+        }
     }
+    return CHESS_SUCCESS;
+}
 
-    Map player_level_map = mapCreate(copyDouble, (copyMapKeyElements)playerCopy, freeDouble, 
-                                    (freeMapKeyElements)playerDestroy, (compareMapKeyElements)comparePlayersLevel);
-    if(player_level_map == NULL)
+ChessResult chessSaveTournamentStatistics (ChessSystem chess, char* path_file)
+{
+    if(chess == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    // checked before opening the file, since CHESS_NO_TOURNAMENTS_ENDED returns before CHESS_SAVE_FAILURE.
+    if(mapIsEmpty(chess->ended_tournaments))
+    {
+        return CHESS_NO_TOURNAMENTS_ENDED;
+    }
+    // the statistics are written to a temporary file which replaces path_file once it is complete, so a failed
+    // save leaves the previous file as it was.
+    char* temp_path = chessCreateTempPath(path_file);
+    if(temp_path == NULL)
     {
         return CHESS_OUT_OF_MEMORY;
     }
+    FILE* stream = fopen(temp_path, "w");
+    if(stream == NULL)
+    {
+        free(temp_path);
+        return CHESS_SAVE_FAILURE;
+    }
+    setvbuf(stream, NULL, _IOFBF, CHESS_SAVE_BUFFER_SIZE);  // the stream is flushed in large writes
 
-    MAP_FOREACH(int*, player_id, all_players)
+    int longest_game_time, number_of_games, number_of_players;
+    double average_game_time;
+    bool write_failed = false;
+    // only the ended tournaments are visited, in the order of their ids.
+    MAP_ITER_FOREACH(ended_iterator, chess->ended_tournaments)
     {
-        Player player = mapGet(all_players, player_id);
-        if(getTotalGamesPlayed(player) > 0) {  // only players with games matter for statistics
-            double level = playerGetLevel(player);
-            mapPut(player_level_map, player, &level);
+        Tournament tournament = mapPeek(chess->tournaments_map, mapIterKey(&ended_iterator));
+        getTournamentStatistics(tournament, &longest_game_time, 
+                                &average_game_time, &number_of_games, &number_of_players);
+        int result = fprintf(stream, "%d\n%d\n%.2f\n%s\n%d\n%d\n",
+                             getTournamentWinnerID(tournament), longest_game_time, average_game_time, 
+                             getTournamentLocation(tournament), number_of_games, number_of_players);
+        if(result <= 0)  // writing falied
+        {
+            write_failed = true;
+            break;
         }
-        freeInt(player_id);
     }
-    MAP_FOREACH(Player, player, player_level_map)
+    if(fclose(stream) != 0 || write_failed || rename(temp_path, path_file) != 0)
     {
-        double* level = mapGet(player_level_map, player);
-        int result = fprintf(file, "%d %.2f\n", (int)player->id, (double)*level);
-        playerDestroy(player);
-        if(result <= 0)  // error while writing
+        remove(temp_path);
+        free(temp_path);
+        return CHESS_SAVE_FAILURE;
+    }
+    free(temp_path);
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessGetTopPlayers(ChessSystem chess, int k, int* player_ids, double* levels, int* count)
+{
+    if(chess == NULL || player_ids == NULL || count == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    *count = 0;
+    MAP_ITER_FOREACH(level_iterator, chess->players_by_level)
+    {
+        if(*count >= k)
         {
-            mapDestroy(all_players);
-            mapDestroy(player_level_map);
-            return CHESS_SAVE_FAILURE;
+            break;
         }
+        Player player = mapIterKey(&level_iterator);
+        player_ids[*count] = player->id;
+        if(levels != NULL)
+        {
+            levels[*count] = *(double*)mapIterPeek(&level_iterator);
+        }
+        (*count)++;
     }
-    mapDestroy(all_players);
-    mapDestroy(player_level_map);
     return CHESS_SUCCESS;
 }
 
-ChessResult chessSaveTournamentStatistics (ChessSystem chess, char* path_file)
+ChessResult chessGetTournamentLeader(ChessSystem chess, int tournament_id, int* leader_id)
+{
+    if(chess == NULL || leader_id == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if(tournament_id <= 0)
+    {
+        return CHESS_INVALID_ID;
+    }
+    Tournament tournament = mapPeek(chess->tournaments_map, &tournament_id);
+    if(tournament == NULL)
+    {
+        return CHESS_TOURNAMENT_NOT_EXIST;
+    }
+    if(getTournamentStatus(tournament) == DONE)
+    {
+        *leader_id = getTournamentWinnerID(tournament);
+        return CHESS_SUCCESS;
+    }
+    Player leader = tournamentGetLeader(tournament);
+    if(leader == NULL)
+    {
+        return CHESS_NO_GAMES;
+    }
+    *leader_id = leader->id;
+    return CHESS_SUCCESS;
+}
+
+ChessResult chessSaveSnapshot(ChessSystem chess, const char* path_file)
+{
+    if(chess == NULL || path_file == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    // written like the statistics: to a temporary file which replaces path_file once it is complete.
+    // the sorted index of the tournaments is built before anything is written, so the loops below can not stop
+    // early and leave a truncated snapshot which would replace path_file.
+    MapIterator first_tournament = mapIterBegin(chess->tournaments_map);
+    char* temp_path = mapIterFailed(&first_tournament) ? NULL : chessCreateTempPath(path_file);
+    if(temp_path == NULL)
+    {
+        return CHESS_OUT_OF_MEMORY;
+    }
+    FILE* stream = fopen(temp_path, "wb");
+    if(stream == NULL)
+    {
+        free(temp_path);
+        return CHESS_SAVE_FAILURE;
+    }
+    setvbuf(stream, NULL, _IOFBF, CHESS_SAVE_BUFFER_SIZE);
+    SnapshotWriter writer = {stream, CHESS_SNAPSHOT_CHECKSUM_BASIS, false};
+
+    snapshotWrite(&writer, CHESS_SNAPSHOT_MAGIC, CHESS_SNAPSHOT_MAGIC_SIZE);
+    snapshotWriteInt(&writer, CHESS_SNAPSHOT_VERSION);
+    snapshotWriteInt(&writer, chess->journal_generation);
+    snapshotWriteInt(&writer, mapGetSize(chess->tournaments_map));
+    int locations_size = 0;
+    MAP_ITER_FOREACH(tournament_iterator, chess->tournaments_map)
+    {
+        Tournament tournament = mapIterPeek(&tournament_iterator);
+        int location_length = strlen(getTournamentLocation(tournament));
+        snapshotWriteInt(&writer, *(int*)mapIterKey(&tournament_iterator));
+        snapshotWriteInt(&writer, getTournamentMaxGamesAllowed(tournament));
+        snapshotWriteInt(&writer, getTournamentStatus(tournament));
+        snapshotWriteInt(&writer, getTournamentWinnerID(tournament));
+        snapshotWriteInt(&writer, getTournamentRemovedPlayers(tournament));
+        snapshotWriteInt(&writer, gamesGetCount(getTournamentGames(tournament)));
+        snapshotWriteInt(&writer, locations_size);
+        snapshotWriteInt(&writer, location_length);
+        locations_size += location_length;
+    }
+    snapshotWriteInt(&writer, locations_size);
+    MAP_ITER_FOREACH(tournament_iterator, chess->tournaments_map)
+    {
+        char* location = getTournamentLocation(mapIterPeek(&tournament_iterator));
+        snapshotWrite(&writer, location, strlen(location));
+    }
+    MAP_ITER_FOREACH(tournament_iterator, chess->tournaments_map)
+    {
+        snapshotWriteGames(&writer, getTournamentGames(mapIterPeek(&tournament_iterator)));
+    }
+    uint32_t checksum = writer.checksum;
+    snapshotWrite(&writer, &checksum, sizeof(checksum));
+
+    if(fclose(stream) != 0 || writer.failed || rename(temp_path, path_file) != 0)
+    {
+        remove(temp_path);
+        free(temp_path);
+        return CHESS_SAVE_FAILURE;
+    }
+    free(temp_path);
+    return CHESS_SUCCESS;
+}
+
+ChessSystem chessLoadSnapshot(const char* path_file, ChessResult* chess_result)
+{
+    if(path_file == NULL || chess_result == NULL)
+    {
+        if(chess_result != NULL)
+        {
+            *chess_result = CHESS_NULL_ARGUMENT;
+        }
+        return NULL;
+    }
+    unsigned char* data = NULL;
+    size_t size = 0;
+    *chess_result = snapshotReadFile(path_file, &data, &size);
+    if(*chess_result != CHESS_SUCCESS)
+    {
+        return NULL;
+    }
+    // the checksum is checked before anything is restored.
+    size_t header_size = CHESS_SNAPSHOT_MAGIC_SIZE + CHESS_SNAPSHOT_INT_SIZE;
+    uint32_t checksum = 0;
+    if(size < header_size + sizeof(checksum))
+    {
+        free(data);
+        *chess_result = CHESS_LOAD_FAILURE;
+        return NULL;
+    }
+    memcpy(&checksum, data + size - sizeof(checksum), sizeof(checksum));
+    SnapshotReader reader = {data, size - sizeof(checksum), 0, false};
+    int version = 0;
+    if(checksum == snapshotChecksum(CHESS_SNAPSHOT_CHECKSUM_BASIS, reader.data, reader.size) &&
+       memcmp(snapshotReadBytes(&reader, CHESS_SNAPSHOT_MAGIC_SIZE), CHESS_SNAPSHOT_MAGIC,
+              CHESS_SNAPSHOT_MAGIC_SIZE) == 0)
+    {
+        version = snapshotReadInt(&reader);
+    }
+    if(version != CHESS_SNAPSHOT_VERSION)
+    {
+        free(data);
+        *chess_result = CHESS_LOAD_FAILURE;
+        return NULL;
+    }
+    int journal_generation = snapshotReadInt(&reader);
+
+    ChessSystem chess = chessCreate();
+    if(chess != NULL)
+    {
+        chess->journal_generation = journal_generation;
+    }
+    *chess_result = chess == NULL ? CHESS_OUT_OF_MEMORY : chessRestoreSnapshot(chess, &reader);
+    free(data);
+    if(*chess_result != CHESS_SUCCESS)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    return chess;
+}
+
+ChessResult chessOpenJournal(ChessSystem chess, const char* snapshot_path, const char* journal_path)
+{
+    if(chess == NULL || snapshot_path == NULL || journal_path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    chessCloseJournal(chess);
+    chess->snapshot_path = copyString(snapshot_path);
+    chess->journal_path = copyString(journal_path);
+    if(chess->snapshot_path == NULL || chess->journal_path == NULL)
+    {
+        chessCloseJournal(chess);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    // the journal starts with a checkpoint, so it holds only the changes made after opening it.
+    ChessResult result = chessCheckpoint(chess);
+    if(result != CHESS_SUCCESS)
+    {
+        chessCloseJournal(chess);
+    }
+    return result;
+}
+
+ChessResult chessCheckpoint(ChessSystem chess)
+{
+    if(chess == NULL || chess->snapshot_path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    // the snapshot of the next generation replaces the old one before the journal is started again, so a stop
+    // in between leaves a journal which is recognized as already checkpointed. if the snapshot was not saved, the
+    // old snapshot and journal are kept as they are, and the changes keep going to the old journal.
+    chess->journal_generation++;
+    ChessResult result = chessSaveSnapshot(chess, chess->snapshot_path);
+    if(result != CHESS_SUCCESS)
+    {
+        chess->journal_generation--;
+        return result;
+    }
+    return chessStartJournal(chess);
+}
+
+ChessResult chessSyncJournal(ChessSystem chess)
+{
+    if(chess == NULL || chess->snapshot_path == NULL)
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    if(chess->journal != NULL && fflush(chess->journal) != 0)
+    {
+        chess->journal_failed = true;
+    }
+    chess->journal_pending = 0;
+    return chess->journal_failed ? CHESS_SAVE_FAILURE : CHESS_SUCCESS;
+}
+
+ChessResult chessCloseJournal(ChessSystem chess)
 {
     if(chess == NULL)
     {
         return CHESS_NULL_ARGUMENT;
     }
-    char* open_method = "w";
-    
-    int longest_game_time, number_of_games, number_of_players, tournaments_ended_counter = 0;
-    double average_game_time;
-    MAP_FOREACH(int*, tournament_id, chess->tournaments_map)
+    ChessResult result = CHESS_SUCCESS;
+    if(chess->journal != NULL)
     {
-        Tournament tournament = mapGet(chess->tournaments_map, tournament_id);
-        if(getTournamentStatus(tournament) == DONE)
+        result = chessSyncJournal(chess);
+        if(fclose(chess->journal) != 0)
         {
-            FILE* stream = fopen(path_file, open_method);  // here becuase of error returning order:
-            open_method = "a";                        // CHESS_NO_TOURNAMENTS_ENDED returns before CHESS_SAVE_FAILURE.
-            if(stream == NULL)                   
-            {
-                return CHESS_SAVE_FAILURE;
-            }
-            tournaments_ended_counter++;
-            getTournamentStatistics(tournament, &longest_game_time, 
-                                    &average_game_time, &number_of_games, &number_of_players);
-            int result = fprintf(stream, "%d\n%d\n%.2f\n%s\n%d\n%d\n",
-                                 getTournamentWinnerID(tournament), longest_game_time, average_game_time, 
-                                 getTournamentLocation(tournament), number_of_games, number_of_players);
-            fclose(stream);  // we open and close more than I would like to. but this follows the instructions easily.
-            if(result <= 0)  // writing falied
-            {
-                freeInt(tournament_id);
-                return CHESS_SAVE_FAILURE;
-            }
+            result = CHESS_SAVE_FAILURE;
         }
-        freeInt(tournament_id);
+        chess->journal = NULL;
     }
-    if(tournaments_ended_counter == 0)
+    free(chess->snapshot_path);
+    free(chess->journal_path);
+    chess->snapshot_path = NULL;
+    chess->journal_path = NULL;
+    chess->journal_failed = false;
+    return result;
+}
+
+ChessSystem chessRecover(const char* snapshot_path, const char* journal_path, ChessResult* chess_result)
+{
+    if(snapshot_path == NULL || journal_path == NULL || chess_result == NULL)
     {
-        return CHESS_NO_TOURNAMENTS_ENDED;
+        if(chess_result != NULL)
+        {
+            *chess_result = CHESS_NULL_ARGUMENT;
+        }
+        return NULL;
     }
+    ChessSystem chess = chessLoadSnapshot(snapshot_path, chess_result);
+    if(chess == NULL)
+    {
+        return NULL;
+    }
+    *chess_result = chessReplayJournal(chess, journal_path);
+    if(*chess_result != CHESS_SUCCESS)
+    {
+        chessDestroy(chess);
+        return NULL;
+    }
+    return chess;
+}
+
+ChessResult chessAddGames(ChessSystem chess, const GameRecord* records, size_t n, ChessResult* results)
+{
+    if(chess == NULL || (n > 0 && (records == NULL || results == NULL)))
+    {
+        return CHESS_NULL_ARGUMENT;
+    }
+    // the records are chained by tournament, so each tournament is looked up once and its records are still
+    // added in the order they were given.
+    Map groups = mapCreateInlineHash(sizeof(int), sizeof(BatchGroup), compareInt, hashInt);
+    size_t* next_record = malloc((n > 0 ? n : 1) * sizeof(*next_record));
+    if(groups == NULL || next_record == NULL)
+    {
+        mapDestroy(groups);
+        free(next_record);
+        return CHESS_OUT_OF_MEMORY;
+    }
+    for(size_t i = 0; i < n; i++)
+    {
+        next_record[i] = n;
+        int tournament_id = records[i].tournament_id;
+        BatchGroup* group = mapGet(groups, &tournament_id);
+        if(group != NULL)
+        {
+            next_record[group->last] = i;
+            group->last = i;
+            continue;
+        }
+        BatchGroup new_group = {i, i};
+        if(mapPut(groups, &tournament_id, &new_group) != MAP_SUCCESS)
+        {
+            mapDestroy(groups);
+            free(next_record);
+            return CHESS_OUT_OF_MEMORY;
+        }
+    }
+
+    // the groups are independent, so they are visited in slot order, which unlike a sorted walk can not fail.
+    for(MapIterator group_iterator = mapIterBeginUnordered(groups); mapIterKey(&group_iterator);
+        mapIterNext(&group_iterator))
+    {
+        int tournament_id = *(int*)mapIterKey(&group_iterator);
+        Tournament tournament = tournament_id > 0 ? mapGet(chess->tournaments_map, &tournament_id) : NULL;
+        BatchGroup* group = mapIterPeek(&group_iterator);
+        for(size_t i = group->first; i < n; i = next_record[i])
+        {
+            const GameRecord* record = records + i;
+            if(tournament_id <= 0 || record->first_player == record->second_player ||
+               record->first_player <= 0 || record->second_player <= 0)
+            {
+                results[i] = CHESS_INVALID_ID;
+                continue;
+            }
+            results[i] = chessAddTournamentGame(chess, tournament_id, tournament, record->first_player,
+                                                record->second_player, record->winner, record->play_time);
+        }
+    }
+    mapDestroy(groups);
+    free(next_record);
     return CHESS_SUCCESS;
-}
\ No newline at end of file
+}
@@ -21,7 +21,8 @@ typedef enum {
     CHESS_NO_TOURNAMENTS_ENDED,
     CHESS_NO_GAMES,
     CHESS_SAVE_FAILURE,
-    CHESS_SUCCESS
+    CHESS_SUCCESS,
+    CHESS_LOAD_FAILURE
 } ChessResult ;
 
 /*
@@ -33,6 +34,15 @@ typedef enum {
     DRAW
 } Winner;
 
+/** Type for describing a game given to chessAddGames, with the arguments of chessAddGame */
+typedef struct game_record_t {
+    int tournament_id;
+    int first_player;
+    int second_player;
+    Winner winner;
+    int play_time;
+} GameRecord;
+
 /** Type for representing a chess system that organizes chess tournaments */
 typedef struct chess_system_t *ChessSystem;
 
@@ -100,6 +110,24 @@ ChessResult chessAddTournament (ChessSystem chess, int tournament_id,
 ChessResult chessAddGame(ChessSystem chess, int tournament_id, int first_player,
                          int second_player, Winner winner, int play_time);
 
+/**
+ * chessAddGames: adds a batch of games, each as chessAddGame would add it. The records are grouped by
+ * tournament, so every tournament is looked up once, and the games of each tournament are added in the
+ * order of the records. Games of different tournaments do not affect each other, so every result is the
+ * one chessAddGame would have returned for the records one after another.
+ *
+ * @param chess - chess system that contains the tournaments. Must be non-NULL.
+ * @param records - the games to add. Must be non-NULL unless n is 0.
+ * @param n - the amount of records.
+ * @param results - an array of n results, the i-th is set to the result of adding the i-th record
+ *                  (see chessAddGame). Must be non-NULL unless n is 0.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL, or records or results are NULL and n is positive.
+ *     CHESS_OUT_OF_MEMORY - if grouping the records failed. No game was added then.
+ *     CHESS_SUCCESS - if every record was tried, in which case results holds the result of each.
+ */
+ChessResult chessAddGames(ChessSystem chess, const GameRecord* records, size_t n, ChessResult* results);
+
 /**
  * chessRemoveTournament: removes the tournament and all the games played in it from the chess system
  *                        updates all players statistics (wins, losses, draws, average play time).
@@ -152,6 +180,7 @@ ChessResult chessRemovePlayer(ChessSystem chess, int player_id);
  *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
  *     CHESS_TOURNAMENT_ENDED - if the tournament already ended
  *     CHESS_N0_GAMES - if the tournament does not have any games.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed. The tournament is not ended then.
  *     CHESS_SUCCESS - if tournament was ended successfully.
  */
 ChessResult chessEndTournament (ChessSystem chess, int tournament_id);
@@ -185,16 +214,154 @@ ChessResult chessSavePlayersLevels (ChessSystem chess, FILE* file);
 
 /**
  * chessSaveTournamentStatistics: prints to the file the statistics for each tournament that ended as
- * explained in the *.pdf
+ * explained in the *.pdf. The file is opened once, and is written as a temporary file next to it which
+ * replaces it when it is complete, so a failed save does not change the file.
  *
  * @param chess - a chess system. Must be non-NULL.
  * @param path_file - the file path which within it the tournament statistics will be saved.
  * @return
  *     CHESS_NULL_ARGUMENT - if chess is NULL.
  *     CHESS_NO_TOURNAMENTS_ENDED - if there are no tournaments ended in the system.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
  *     CHESS_SAVE_FAILURE - if an error occurred while saving.
  *     CHESS_SUCCESS - if the ratings was printed successfully.
  */
 ChessResult chessSaveTournamentStatistics (ChessSystem chess, char* path_file);
 
+/**
+ * chessGetTopPlayers: returns the k players with the highest levels in the system, in the order
+ * chessSavePlayersLevels prints them. Only the returned players are visited.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param k - the amount of players to return.
+ * @param player_ids - an array of at least k elements, to which the players' IDs are written. Must be non-NULL.
+ * @param levels - an array of at least k elements, to which the players' levels are written. May be NULL.
+ * @param count - this variable will contain the amount of players written, which is smaller than k if
+ *     there are fewer players in the system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess, player_ids or count are NULL.
+ *     CHESS_SUCCESS - if the players were returned successfully.
+ */
+ChessResult chessGetTopPlayers (ChessSystem chess, int k, int* player_ids, double* levels, int* count);
+
+/**
+ * chessGetTournamentLeader: returns the player who would win a tournament if it ended now. For an ended
+ * tournament, returns its winner.
+ *
+ * @param chess - a chess system that contains the tournament. Must be non-NULL.
+ * @param tournament_id - the tournament ID. Must be positive.
+ * @param leader_id - this variable will contain the leader's ID. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or leader_id are NULL.
+ *     CHESS_INVALID_ID - if the tournament ID number is invalid.
+ *     CHESS_TOURNAMENT_NOT_EXIST - if the tournament does not exist in the system.
+ *     CHESS_NO_GAMES - if the tournament is in progress and has no games with players who were not removed.
+ *     CHESS_SUCCESS - if the leader was returned successfully.
+ */
+ChessResult chessGetTournamentLeader (ChessSystem chess, int tournament_id, int* leader_id);
+
+/**
+ * chessSaveSnapshot: saves the whole chess system to a binary file, from which chessLoadSnapshot
+ * restores it. The file holds a table of the tournaments, their locations and their games (each
+ * field of the games in its own column), followed by a checksum. It is written as a temporary file
+ * next to path_file, which replaces path_file when it is complete.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param path_file - the path of the snapshot file. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess or path_file are NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving.
+ *     CHESS_SUCCESS - if the snapshot was saved successfully.
+ */
+ChessResult chessSaveSnapshot (ChessSystem chess, const char* path_file);
+
+/**
+ * chessLoadSnapshot: creates a chess system from a snapshot saved by chessSaveSnapshot. The file is
+ * read into memory at once, and its checksum is verified before anything is restored. The statistics
+ * of the players are restored from the games.
+ *
+ * @param path_file - the path of the snapshot file. Must be non-NULL.
+ * @param chess_result - this variable will contain the returned error code. Must be non-NULL.
+ * @return
+ *     A new chess system in case of success, and NULL otherwise. chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if path_file is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_LOAD_FAILURE - if the file could not be read, or is not a valid snapshot of this version.
+ *     CHESS_SUCCESS - if the chess system was restored successfully.
+ */
+ChessSystem chessLoadSnapshot (const char* path_file, ChessResult* chess_result);
+
+/**
+ * chessOpenJournal: starts journaling the chess system. Every successful call to chessAddTournament,
+ * chessAddGame, chessRemoveTournament, chessRemovePlayer and chessEndTournament then appends a record
+ * to the journal at journal_path, so chessRecover can restore the system after a crash. Opening the
+ * journal makes a checkpoint, which saves a snapshot to snapshot_path and starts an empty journal.
+ * The records are written in groups, so a crash may lose the records of the last group which was not
+ * flushed yet (see chessSyncJournal). A journal which was already open is closed first.
+ *
+ * @param chess - a chess system. Must be non-NULL.
+ * @param snapshot_path - the path of the snapshot of the checkpoints. Must be non-NULL.
+ * @param journal_path - the path of the journal. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving the snapshot or starting the journal.
+ *     CHESS_SUCCESS - if the system is journaled.
+ */
+ChessResult chessOpenJournal (ChessSystem chess, const char* snapshot_path, const char* journal_path);
+
+/**
+ * chessCheckpoint: saves a snapshot of the chess system and starts an empty journal, so the records
+ * written until now need not be replayed.
+ *
+ * @param chess - a journaled chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL or is not journaled.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_SAVE_FAILURE - if an error occurred while saving the snapshot or starting the journal.
+ *     CHESS_SUCCESS - if the checkpoint was made successfully.
+ */
+ChessResult chessCheckpoint (ChessSystem chess);
+
+/**
+ * chessSyncJournal: flushes the journal records which were not flushed yet.
+ *
+ * @param chess - a journaled chess system. Must be non-NULL.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL or is not journaled.
+ *     CHESS_SAVE_FAILURE - if a record could not be written since the last checkpoint.
+ *     CHESS_SUCCESS - if all the records were written.
+ */
+ChessResult chessSyncJournal (ChessSystem chess);
+
+/**
+ * chessCloseJournal: flushes the journal and stops journaling. chessDestroy closes the journal as well.
+ *
+ * @param chess - a chess system. Must be non-NULL. If it is not journaled, the function does nothing.
+ * @return
+ *     CHESS_NULL_ARGUMENT - if chess is NULL.
+ *     CHESS_SAVE_FAILURE - if a record could not be written since the last checkpoint.
+ *     CHESS_SUCCESS - otherwise.
+ */
+ChessResult chessCloseJournal (ChessSystem chess);
+
+/**
+ * chessRecover: creates a chess system from the snapshot of the last checkpoint, and then replays the
+ * records of the journal. The journal ends at a record which was not fully written. The returned system
+ * is not journaled, chessOpenJournal continues journaling it.
+ *
+ * @param snapshot_path - the path of the snapshot given to chessOpenJournal. Must be non-NULL.
+ * @param journal_path - the path of the journal given to chessOpenJournal. Must be non-NULL.
+ * @param chess_result - this variable will contain the returned error code. Must be non-NULL.
+ * @return
+ *     A new chess system in case of success, and NULL otherwise. chess_result is set to:
+ *     CHESS_NULL_ARGUMENT - if one of the arguments is NULL.
+ *     CHESS_OUT_OF_MEMORY - if an allocation failed.
+ *     CHESS_LOAD_FAILURE - if a file could not be read, is not valid, or the journal does not belong
+ *                          to the snapshot.
+ *     CHESS_SUCCESS - if the chess system was recovered successfully.
+ */
+ChessSystem chessRecover (const char* snapshot_path, const char* journal_path, ChessResult* chess_result);
+
 #endif //HW1_CHESSSYSTEM_H
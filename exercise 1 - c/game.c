@@ -1,77 +1,202 @@
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include "game.h"
 
+#define GAMES_FIRST_CAPACITY 8
 
-struct game_t {
-    int player_1;
-    int player_2;
-    Winner winner;
-    int game_time;
+// the i-th game is made of the i-th element of every column.
+struct games_t {
+    int* player_1;
+    int* player_2;
+    uint8_t* winner;
+    int* game_time;
+    int* next_1;  // the index of the next game of player_1, or NO_NEXT_GAME
+    int* next_2;  // the index of the next game of player_2, or NO_NEXT_GAME
+    int count;
+    int capacity;
 };
 
+// HELPER FUNCTIONS START
 
-Game gameCreate(int player_1, int player_2, Winner winner, int game_time)
+// reallocates a column to hold capacity elements of element_size bytes. on failure the column is not changed.
+static bool gamesResizeColumn(void** column, int capacity, size_t element_size)
 {
-    Game game = malloc(sizeof(*game));
-    if(game == NULL)
+    void* resized = realloc(*column, element_size * capacity);
+    if(resized == NULL)
+    {
+        return false;
+    }
+    *column = resized;
+    return true;
+}
+
+// makes room for capacity games. columns which were already grown stay grown if a later one fails, which is
+// harmless since the capacity is only updated once all of them have room.
+static bool gamesReserve(Games games, int capacity)
+{
+    if(capacity <= games->capacity)
+    {
+        return true;
+    }
+    if(!gamesResizeColumn((void**)&games->player_1, capacity, sizeof(*games->player_1)) ||
+       !gamesResizeColumn((void**)&games->player_2, capacity, sizeof(*games->player_2)) ||
+       !gamesResizeColumn((void**)&games->winner, capacity, sizeof(*games->winner)) ||
+       !gamesResizeColumn((void**)&games->game_time, capacity, sizeof(*games->game_time)) ||
+       !gamesResizeColumn((void**)&games->next_1, capacity, sizeof(*games->next_1)) ||
+       !gamesResizeColumn((void**)&games->next_2, capacity, sizeof(*games->next_2)))
+    {
+        return false;
+    }
+    games->capacity = capacity;
+    return true;
+}
+
+// HELPER FUNCTIONS END
+
+Games gamesCreate()
+{
+    Games games = malloc(sizeof(*games));
+    if(games == NULL)
     {
         return NULL;
     }
-    game->player_1 = player_1;
-    game->player_2 = player_2;
-    game->winner = winner;
-    game->game_time = game_time;
-    return game;
+    games->player_1 = NULL;
+    games->player_2 = NULL;
+    games->winner = NULL;
+    games->game_time = NULL;
+    games->next_1 = NULL;
+    games->next_2 = NULL;
+    games->count = 0;
+    games->capacity = 0;
+    return games;
+}
+
+void gamesDestroy(Games games)
+{
+    if(games == NULL)
+    {
+        return;
+    }
+    free(games->player_1);
+    free(games->player_2);
+    free(games->winner);
+    free(games->game_time);
+    free(games->next_1);
+    free(games->next_2);
+    free(games);
 }
 
-Game gameCopy(Game game)
+Games gamesCopy(Games games)
 {
-    Game copy = gameCreate(game->player_1, game->player_2, 
-                           game->winner, game->game_time);
+    if(games == NULL)
+    {
+        return NULL;
+    }
+    Games copy = gamesCreate();
     if(copy == NULL)
     {
         return NULL;
     }
+    if(!gamesReserve(copy, games->count))
+    {
+        gamesDestroy(copy);
+        return NULL;
+    }
+    if(games->count > 0)
+    {
+        memcpy(copy->player_1, games->player_1, sizeof(*games->player_1) * games->count);
+        memcpy(copy->player_2, games->player_2, sizeof(*games->player_2) * games->count);
+        memcpy(copy->winner, games->winner, sizeof(*games->winner) * games->count);
+        memcpy(copy->game_time, games->game_time, sizeof(*games->game_time) * games->count);
+        memcpy(copy->next_1, games->next_1, sizeof(*games->next_1) * games->count);
+        memcpy(copy->next_2, games->next_2, sizeof(*games->next_2) * games->count);
+    }
+    copy->count = games->count;
     return copy;
 }
 
-void gameDestroy(Game game)
+GameErrors gamesAdd(Games games, int player_1, int player_2, Winner winner, int game_time)
+{
+    if(games == NULL)
+    {
+        return GAME_NULL_ARGUMENTS;
+    }
+    if(games->count == games->capacity &&
+       !gamesReserve(games, games->capacity == 0 ? GAMES_FIRST_CAPACITY : games->capacity * 2))
+    {
+        return GAME_OUT_OF_MEMORY;
+    }
+    games->player_1[games->count] = player_1;
+    games->player_2[games->count] = player_2;
+    games->winner[games->count] = (uint8_t)winner;
+    games->game_time[games->count] = game_time;
+    games->next_1[games->count] = NO_NEXT_GAME;
+    games->next_2[games->count] = NO_NEXT_GAME;
+    games->count++;
+    return GAME_SUCCESS;
+}
+
+int gamesGetCount(Games games)
+{
+    return games == NULL ? 0 : games->count;
+}
+
+void gamesSetNextOfPlayer(Games games, int index, int player_id, int next_index)
+{
+    if(games->player_1[index] == player_id)
+    {
+        games->next_1[index] = next_index;
+    }
+    else
+    {
+        games->next_2[index] = next_index;
+    }
+}
+
+int gamesGetNextOfPlayer(Games games, int index, int player_id)
+{
+    return games->player_1[index] == player_id ? games->next_1[index] : games->next_2[index];
+}
+
+struct game_t gamesGet(Games games, int index)
 {
-    free(game);
+    struct game_t game = {games, index};
+    return game;
 }
 
 int getPlayer1ID(Game game)
 {
-    return game->player_1;
+    return game->games->player_1[game->index];
 }
 
 int getPlayer2ID(Game game)
 {
-    return game->player_2;
+    return game->games->player_2[game->index];
 }
 
 Winner getWinner(Game game)
 {
-    return game->winner;
+    return (Winner)game->games->winner[game->index];
 }
 
 int getGameTime(Game game)
 {
-    return game->game_time;
+    return game->games->game_time[game->index];
 }
 
 void setPlayer1(Game game, int player1_id)
 {
-    game->player_1 = player1_id;
+    game->games->player_1[game->index] = player1_id;
 }
 
 void setPlayer2(Game game, int player2_id)
 {
-    game->player_2 = player2_id;
+    game->games->player_2[game->index] = player2_id;
 }
 
 void setWinner(Game game, Winner winner)
 {
-    game->winner = winner;
+    game->games->winner[game->index] = (uint8_t)winner;
 }
\ No newline at end of file
@@ -2,8 +2,16 @@
 #define _GAME_H
 
 #define PLAYER_REMOVED -1
+#define NO_NEXT_GAME -1
 
-typedef struct game_t *Game;
+typedef struct games_t *Games;
+
+// a view of a single game inside a Games store. games are kept in columns (one array per field), so there is
+// no record of a single game to point to.
+typedef struct game_t {
+    Games games;
+    int index;
+} *Game;
 
 typedef enum{
     GAME_SUCCESS,
@@ -21,37 +29,69 @@ typedef enum {
 #endif
 
 /**
-* gameCreate: Allocates a new game.
+* gamesCreate: Allocates a new empty store of games.
+*
+* @return
+* 	NULL - if allocations failed.
+* 	A new store in case of success.
+*/
+Games gamesCreate();
+
+/**
+* gamesDestroy: Deallocates an existing store and all of its games.
 *
+* @param games - Target store to be deallocated. If games is NULL nothing will be
+* 		done
+*/
+void gamesDestroy(Games games);
+
+/**
+* gamesCopy: Creates a copy of target store.
+*
+* @param games - Target store.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A store containing the same games as games otherwise.
+*/
+Games gamesCopy(Games games);
+
+/**
+* gamesAdd: Adds a game at the end of the store.
+*
+* @param games - Target store.
 * @param player1 - player 1 id
 * @param player2 - player 2 id
 * @param winner - FIRST_PLAYER, SECOND_PLAYER or DRAW
 * @param game_time - length of the game in seconds.
 *
 * @return
-* 	NULL - if one of the parameters is NULL or allocations failed.
-* 	A new game in case of success.
+* 	GAME_NULL_ARGUMENTS - if games is NULL.
+* 	GAME_OUT_OF_MEMORY - if growing the store failed. the store is not changed.
+* 	GAME_SUCCESS - otherwise.
 */
-Game gameCreate(int player_1, int player_2, Winner winner, int game_time);
+GameErrors gamesAdd(Games games, int player_1, int player_2, Winner winner, int game_time);
+
+// returns the amount of games in the store, or 0 if games is NULL.
+int gamesGetCount(Games games);
 
 /**
-* gameDestroy: Deallocates an existing game. Clears all elements by using the
-* stored free functions.
+* gamesSetNextOfPlayer: links the games of a player into a chain, by setting the game which follows the index-th
+* game among the games of player_id. every game has a link for each of its players, so their chains do not mix.
+* assumes player_id is one of the players of the index-th game. a new game is not followed by any game.
 *
-* @param game - Target game to be deallocated. If game is NULL nothing will be
-* 		done
+* @param next_index - the index of the next game of player_id, or NO_NEXT_GAME.
 */
-void gameDestroy(Game game);
+void gamesSetNextOfPlayer(Games games, int index, int player_id, int next_index);
+
+// returns the index of the game which follows the index-th game among the games of player_id (as set by
+// gamesSetNextOfPlayer), or NO_NEXT_GAME. assumes player_id is one of the players of the index-th game.
+int gamesGetNextOfPlayer(Games games, int index, int player_id);
 
 /**
-* gameCopy: Creates a copy of target game.
-*
-* @param game - Target game.
-* @return
-* 	NULL if a NULL was sent or a memory allocation failed.
-* 	A Game containing the same elements as game otherwise.
+* gamesGet: returns a view of the index-th game of the store, to be used with the accessors below through
+* its address. assumes 0 <= index < gamesGetCount(games).
 */
-Game gameCopy(Game game);
+struct game_t gamesGet(Games games, int index);
 
 /**
  * getPlayer1ID: returns player 1's ID.
@@ -0,0 +1,660 @@
+#include <stdlib.h>
+#include <string.h>
+#include "hashTable.h"
+
+#define HASH_TABLE_INITIAL_CAPACITY 16
+// the table grows when more than MAX_LOAD_NUMERATOR/MAX_LOAD_DENOMINATOR of it is in use.
+#define MAX_LOAD_NUMERATOR 7
+#define MAX_LOAD_DENOMINATOR 10
+
+// used for rounding the sizes of inline elements, so every element is aligned for any type.
+typedef union hash_table_alignment_t {
+    long double long_double_member;
+    long long long_long_member;
+    void* pointer_member;
+} HashTableAlignment;
+
+// the key and data of entries of several tables, after a table was copied. allocated from element_pool.
+struct hash_element_t {
+    HashKeyElement key;
+    HashDataElement data;
+    int references;
+};
+
+struct hash_table_t {
+    struct hash_entry_t* entries;
+    int capacity;  // always a power of 2
+    int size;
+    bool is_inline;  // keys and data are stored in storage, next to each other, and copied with memcpy
+    size_t key_size;
+    size_t data_size;
+    size_t slot_size;  // bytes of storage used by each slot
+    char* storage;
+    int* sorted;  // slot indices ordered by key, valid only if is_sorted is true
+    bool is_sorted;
+    copyHashDataElement copyData;
+    copyHashKeyElement copyKey;
+    freeHashDataElement freeData;
+    freeHashKeyElement freeKey;
+    compareHashKeyElements compare;
+    hashHashKeyElement hash;
+    Pool element_pool;  // shared with the copies of the table. NULL until the table is copied
+};
+
+// HELPER FUNCTIONS START
+
+// mixes the bits of the user's hash, so simple hashes such as the identity of an int spread over the table.
+static unsigned int hashMix(unsigned int hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static size_t alignedSize(size_t size)
+{
+    return (size + sizeof(HashTableAlignment) - 1) / sizeof(HashTableAlignment) * sizeof(HashTableAlignment);
+}
+
+// allocates the entries (and the inline storage) for capacity slots. returns false on memory allocation error.
+static bool hashTableAllocateSlots(HashTable table, int capacity, struct hash_entry_t** entries, char** storage)
+{
+    *entries = calloc(capacity, sizeof(**entries));
+    *storage = NULL;
+    if(*entries != NULL && table->is_inline)
+    {
+        *storage = malloc(table->slot_size * capacity);
+        if(*storage == NULL)
+        {
+            free(*entries);
+            *entries = NULL;
+        }
+    }
+    return *entries != NULL;
+}
+
+// writes entry to slot. the key and data of an inline entry are copied into the storage of the slot.
+static void hashTablePlaceEntry(HashTable table, struct hash_entry_t* entries, char* storage, int slot,
+                                struct hash_entry_t entry)
+{
+    if(table->is_inline)
+    {
+        char* slot_storage = storage + table->slot_size * slot;
+        memmove(slot_storage, entry.key, table->key_size);
+        memmove(slot_storage + alignedSize(table->key_size), entry.data, table->data_size);
+        entry.key = slot_storage;
+        entry.data = slot_storage + alignedSize(table->key_size);
+    }
+    entries[slot] = entry;
+}
+
+// frees the key and data of an entry, but does not empty its slot. shared key and data are freed by their last
+// entry.
+static void hashTableFreeEntry(HashTable table, HashEntry entry)
+{
+    if(table->is_inline)
+    {
+        return;
+    }
+    if(entry->element != NULL)
+    {
+        entry->element->references--;
+        if(entry->element->references > 0)
+        {
+            entry->element = NULL;
+            return;
+        }
+        poolFree(table->element_pool, entry->element);
+        entry->element = NULL;
+    }
+    table->freeData(entry->data);
+    table->freeKey(entry->key);
+}
+
+// makes the key and data of an entry private to it, copying them if they are shared. returns false on
+// memory allocation error.
+static bool hashTableOwnEntry(HashTable table, HashEntry entry)
+{
+    if(table->is_inline || entry->element == NULL)
+    {
+        return true;
+    }
+    if(entry->element->references == 1)
+    {
+        poolFree(table->element_pool, entry->element);
+        entry->element = NULL;
+        return true;
+    }
+    HashKeyElement key = table->copyKey(entry->key);
+    HashDataElement data = table->copyData(entry->data);
+    if(key == NULL || data == NULL)
+    {
+        table->freeKey(key);
+        table->freeData(data);
+        return false;
+    }
+    entry->element->references--;
+    entry->element = NULL;
+    entry->key = key;
+    entry->data = data;
+    return true;
+}
+
+// returns the slot of key, or the empty slot where it should be inserted.
+static int hashTableProbe(HashTable table, HashKeyElement key, unsigned int hash)
+{
+    int mask = table->capacity - 1;
+    int slot = hash & mask;
+    while(table->entries[slot].key != NULL)
+    {
+        if(table->entries[slot].hash == hash && table->compare(table->entries[slot].key, key) == 0)
+        {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static bool hashTableResize(HashTable table, int new_capacity)
+{
+    struct hash_entry_t* new_entries = NULL;
+    char* new_storage = NULL;
+    if(hashTableAllocateSlots(table, new_capacity, &new_entries, &new_storage) == false)
+    {
+        return false;
+    }
+    int mask = new_capacity - 1;
+    for(int i = 0; i < table->capacity; i++)
+    {
+        if(table->entries[i].key != NULL)
+        {
+            int slot = table->entries[i].hash & mask;
+            while(new_entries[slot].key != NULL)
+            {
+                slot = (slot + 1) & mask;
+            }
+            hashTablePlaceEntry(table, new_entries, new_storage, slot, table->entries[i]);
+        }
+    }
+    free(table->entries);
+    free(table->storage);
+    table->entries = new_entries;
+    table->storage = new_storage;
+    table->capacity = new_capacity;
+    table->is_sorted = false;
+    return true;
+}
+
+// sorts slots[low, high) by the keys of their entries, using buffer as scratch space.
+static void hashTableMergeSort(HashTable table, int* slots, int* buffer, int low, int high)
+{
+    if(high - low < 2)
+    {
+        return;
+    }
+    int middle = low + (high - low) / 2;
+    hashTableMergeSort(table, slots, buffer, low, middle);
+    hashTableMergeSort(table, slots, buffer, middle, high);
+    int left = low, right = middle, index = low;
+    while(left < middle && right < high)
+    {
+        if(table->compare(table->entries[slots[left]].key, table->entries[slots[right]].key) <= 0)
+        {
+            buffer[index++] = slots[left++];
+        }
+        else
+        {
+            buffer[index++] = slots[right++];
+        }
+    }
+    while(left < middle)
+    {
+        buffer[index++] = slots[left++];
+    }
+    while(right < high)
+    {
+        buffer[index++] = slots[right++];
+    }
+    memcpy(slots + low, buffer + low, sizeof(*slots) * (high - low));
+}
+
+static bool hashTableBuildSortedIndex(HashTable table)
+{
+    int* sorted = malloc(sizeof(*sorted) * (table->size + 1));
+    int* buffer = malloc(sizeof(*buffer) * (table->size + 1));
+    if(sorted == NULL || buffer == NULL)
+    {
+        free(sorted);
+        free(buffer);
+        return false;
+    }
+    int count = 0;
+    for(int i = 0; i < table->capacity; i++)
+    {
+        if(table->entries[i].key != NULL)
+        {
+            sorted[count++] = i;
+        }
+    }
+    hashTableMergeSort(table, sorted, buffer, 0, count);
+    free(buffer);
+    free(table->sorted);
+    table->sorted = sorted;
+    table->is_sorted = true;
+    return true;
+}
+
+static HashTable hashTableAllocate(bool is_inline, size_t key_size, size_t data_size,
+                                   compareHashKeyElements compare, hashHashKeyElement hash)
+{
+    HashTable table = malloc(sizeof(*table));
+    if(table == NULL)
+    {
+        return NULL;
+    }
+    table->is_inline = is_inline;
+    table->key_size = key_size;
+    table->data_size = data_size;
+    table->slot_size = alignedSize(key_size) + alignedSize(data_size);
+    if(hashTableAllocateSlots(table, HASH_TABLE_INITIAL_CAPACITY, &table->entries, &table->storage) == false)
+    {
+        free(table);
+        return NULL;
+    }
+    table->capacity = HASH_TABLE_INITIAL_CAPACITY;
+    table->size = 0;
+    table->sorted = NULL;
+    table->is_sorted = false;
+    table->copyData = NULL;
+    table->copyKey = NULL;
+    table->freeData = NULL;
+    table->freeKey = NULL;
+    table->compare = compare;
+    table->hash = hash;
+    table->element_pool = NULL;
+    return table;
+}
+
+// HELPER FUNCTIONS END
+
+HashTable hashTableCreate(copyHashDataElement copyData, copyHashKeyElement copyKey,
+                          freeHashDataElement freeData, freeHashKeyElement freeKey,
+                          compareHashKeyElements compare, hashHashKeyElement hash)
+{
+    if(!copyData || !copyKey || !freeData || !freeKey || !compare || !hash)
+    {
+        return NULL;
+    }
+    HashTable table = hashTableAllocate(false, 0, 0, compare, hash);
+    if(table == NULL)
+    {
+        return NULL;
+    }
+    table->copyData = copyData;
+    table->copyKey = copyKey;
+    table->freeData = freeData;
+    table->freeKey = freeKey;
+    return table;
+}
+
+HashTable hashTableCreateInline(size_t key_size, size_t data_size,
+                                compareHashKeyElements compare, hashHashKeyElement hash)
+{
+    if(key_size == 0 || !compare || !hash)
+    {
+        return NULL;
+    }
+    return hashTableAllocate(true, key_size, data_size, compare, hash);
+}
+
+void hashTableDestroy(HashTable table)
+{
+    if(table == NULL)
+    {
+        return;
+    }
+    hashTableClear(table);
+    free(table->entries);
+    free(table->storage);
+    free(table->sorted);
+    poolDestroy(table->element_pool);
+    free(table);
+}
+
+HashTable hashTableCopy(HashTable table)
+{
+    if(table == NULL)
+    {
+        return NULL;
+    }
+    HashTable new_table = hashTableAllocate(table->is_inline, table->key_size, table->data_size,
+                                            table->compare, table->hash);
+    if(new_table == NULL)
+    {
+        return NULL;
+    }
+    new_table->copyData = table->copyData;
+    new_table->copyKey = table->copyKey;
+    new_table->freeData = table->freeData;
+    new_table->freeKey = table->freeKey;
+    if(table->is_inline == false && table->element_pool == NULL)
+    {
+        table->element_pool = poolCreate(sizeof(struct hash_element_t));
+    }
+    if(table->is_inline == false)
+    {
+        new_table->element_pool = poolShare(table->element_pool);
+    }
+    if((table->is_inline == false && new_table->element_pool == NULL) ||
+       hashTableResize(new_table, table->capacity) == false)
+    {
+        hashTableDestroy(new_table);
+        return NULL;
+    }
+    // same capacity, so every element keeps its slot.
+    for(int i = 0; i < table->capacity; i++)
+    {
+        HashEntry entry = &table->entries[i];
+        if(entry->key == NULL)
+        {
+            continue;
+        }
+        if(table->is_inline == false && entry->element == NULL)  // the element becomes shared
+        {
+            entry->element = poolAlloc(table->element_pool);
+            if(entry->element == NULL)
+            {
+                hashTableDestroy(new_table);
+                return NULL;
+            }
+            entry->element->key = entry->key;
+            entry->element->data = entry->data;
+            entry->element->references = 1;
+        }
+        if(table->is_inline == false)
+        {
+            entry->element->references++;
+        }
+        hashTablePlaceEntry(new_table, new_table->entries, new_table->storage, i, *entry);
+        new_table->size++;
+    }
+    return new_table;
+}
+
+int hashTableGetSize(HashTable table)
+{
+    if(table == NULL)
+    {
+        return -1;
+    }
+    return table->size;
+}
+
+HashEntry hashTableFind(HashTable table, HashKeyElement key)
+{
+    if(table == NULL || key == NULL)
+    {
+        return NULL;
+    }
+    HashEntry entry = &table->entries[hashTableProbe(table, key, hashMix(table->hash(key)))];
+    return entry->key == NULL ? NULL : entry;
+}
+
+HashEntry hashTableFindForWrite(HashTable table, HashKeyElement key)
+{
+    HashEntry entry = hashTableFind(table, key);
+    if(entry == NULL || hashTableOwnEntry(table, entry) == false)
+    {
+        return NULL;
+    }
+    return entry;
+}
+
+HashTableError hashTablePut(HashTable table, HashKeyElement key, HashDataElement data)
+{
+    if(table == NULL || key == NULL || data == NULL)
+    {
+        return HASH_TABLE_NULL_ARGUMENT;
+    }
+    unsigned int hash = hashMix(table->hash(key));
+    HashEntry entry = &table->entries[hashTableProbe(table, key, hash)];
+    if(entry->key != NULL && table->is_inline)  // key exists, replace its data
+    {
+        memmove(entry->data, data, table->data_size);
+        return HASH_TABLE_SUCCESS;
+    }
+    if(entry->key != NULL)
+    {
+        HashDataElement new_data = table->copyData(data);
+        if(new_data == NULL)
+        {
+            return HASH_TABLE_OUT_OF_MEMORY;
+        }
+        if(entry->element != NULL)  // the key and data are shared, so they are released and the key is copied
+        {
+            HashKeyElement new_key = table->copyKey(entry->key);
+            if(new_key == NULL)
+            {
+                table->freeData(new_data);
+                return HASH_TABLE_OUT_OF_MEMORY;
+            }
+            hashTableFreeEntry(table, entry);
+            entry->key = new_key;
+        }
+        else
+        {
+            table->freeData(entry->data);
+        }
+        entry->data = new_data;
+        return HASH_TABLE_SUCCESS;
+    }
+
+    if((table->size + 1) * MAX_LOAD_DENOMINATOR > table->capacity * MAX_LOAD_NUMERATOR)
+    {
+        if(hashTableResize(table, table->capacity * 2) == false)
+        {
+            return HASH_TABLE_OUT_OF_MEMORY;
+        }
+        entry = &table->entries[hashTableProbe(table, key, hash)];
+    }
+    if(table->is_inline)
+    {
+        struct hash_entry_t new_entry = {key, data, hash};
+        hashTablePlaceEntry(table, table->entries, table->storage, entry - table->entries, new_entry);
+        table->size++;
+        table->is_sorted = false;
+        return HASH_TABLE_SUCCESS;
+    }
+    HashKeyElement new_key = table->copyKey(key);
+    HashDataElement new_data = table->copyData(data);
+    if(new_key == NULL || new_data == NULL)
+    {
+        table->freeKey(new_key);
+        table->freeData(new_data);
+        return HASH_TABLE_OUT_OF_MEMORY;
+    }
+    entry->key = new_key;
+    entry->data = new_data;
+    entry->hash = hash;
+    entry->element = NULL;
+    table->size++;
+    table->is_sorted = false;
+    return HASH_TABLE_SUCCESS;
+}
+
+HashTableError hashTablePutTake(HashTable table, HashKeyElement key, HashDataElement data)
+{
+    if(table == NULL || key == NULL || data == NULL || table->is_inline)
+    {
+        return HASH_TABLE_NULL_ARGUMENT;
+    }
+    unsigned int hash = hashMix(table->hash(key));
+    HashEntry entry = &table->entries[hashTableProbe(table, key, hash)];
+    if(entry->key != NULL && entry->element != NULL)  // key exists and is shared, release it and its data
+    {
+        hashTableFreeEntry(table, entry);
+        entry->key = key;
+        entry->data = data;
+        return HASH_TABLE_SUCCESS;
+    }
+    if(entry->key != NULL)  // key exists, replace its data
+    {
+        if(entry->data != data)
+        {
+            table->freeData(entry->data);
+            entry->data = data;
+        }
+        if(entry->key != key)
+        {
+            table->freeKey(key);
+        }
+        return HASH_TABLE_SUCCESS;
+    }
+
+    if((table->size + 1) * MAX_LOAD_DENOMINATOR > table->capacity * MAX_LOAD_NUMERATOR)
+    {
+        if(hashTableResize(table, table->capacity * 2) == false)
+        {
+            return HASH_TABLE_OUT_OF_MEMORY;
+        }
+        entry = &table->entries[hashTableProbe(table, key, hash)];
+    }
+    entry->key = key;
+    entry->data = data;
+    entry->hash = hash;
+    entry->element = NULL;
+    table->size++;
+    table->is_sorted = false;
+    return HASH_TABLE_SUCCESS;
+}
+
+HashTableError hashTableRemove(HashTable table, HashKeyElement key)
+{
+    if(table == NULL || key == NULL)
+    {
+        return HASH_TABLE_NULL_ARGUMENT;
+    }
+    int slot = hashTableProbe(table, key, hashMix(table->hash(key)));
+    if(table->entries[slot].key == NULL)
+    {
+        return HASH_TABLE_ITEM_DOES_NOT_EXIST;
+    }
+    hashTableFreeEntry(table, &table->entries[slot]);
+    table->entries[slot].key = NULL;
+    table->size--;
+    table->is_sorted = false;
+
+    // shift back the following entries of the cluster, so no lookup stops early at the new hole.
+    int mask = table->capacity - 1;
+    int hole = slot;
+    int next = (slot + 1) & mask;
+    while(table->entries[next].key != NULL)
+    {
+        int home = table->entries[next].hash & mask;
+        // the entry may move to the hole only if its home slot is not between the hole and itself.
+        if(((next - home) & mask) >= ((next - hole) & mask))
+        {
+            hashTablePlaceEntry(table, table->entries, table->storage, hole, table->entries[next]);
+            table->entries[next].key = NULL;
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    return HASH_TABLE_SUCCESS;
+}
+
+void hashTableClear(HashTable table)
+{
+    if(table == NULL)
+    {
+        return;
+    }
+    for(int i = 0; i < table->capacity; i++)
+    {
+        if(table->entries[i].key != NULL)
+        {
+            hashTableFreeEntry(table, &table->entries[i]);
+            table->entries[i].key = NULL;
+        }
+    }
+    table->size = 0;
+    table->is_sorted = false;
+}
+
+bool hashTableSort(HashTable table)
+{
+    if(table == NULL)
+    {
+        return false;
+    }
+    return table->is_sorted || hashTableBuildSortedIndex(table);
+}
+
+int hashTableGetSortedBound(HashTable table, HashKeyElement key, bool strict)
+{
+    if(table == NULL || key == NULL)
+    {
+        return -1;
+    }
+    if(table->is_sorted == false && hashTableBuildSortedIndex(table) == false)
+    {
+        return -1;
+    }
+    int low = 0, high = table->size;
+    while(low < high)
+    {
+        int middle = low + (high - low) / 2;
+        int compare_result = table->compare(table->entries[table->sorted[middle]].key, key);
+        if(compare_result < 0 || (strict && compare_result == 0))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+HashEntry hashTableGetSorted(HashTable table, int index)
+{
+    if(table == NULL || index < 0 || index >= table->size)
+    {
+        return NULL;
+    }
+    if(table->is_sorted == false && hashTableBuildSortedIndex(table) == false)
+    {
+        return NULL;
+    }
+    return &table->entries[table->sorted[index]];
+}
+
+int hashTableNextSlot(HashTable table, int slot)
+{
+    if(table == NULL || slot < 0)
+    {
+        return -1;
+    }
+    for(; slot < table->capacity; slot++)
+    {
+        if(table->entries[slot].key != NULL)
+        {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+HashEntry hashTableGetSlot(HashTable table, int slot)
+{
+    if(table == NULL || slot < 0 || slot >= table->capacity || table->entries[slot].key == NULL)
+    {
+        return NULL;
+    }
+    return &table->entries[slot];
+}
@@ -0,0 +1,125 @@
+#ifndef HASH_TABLE_H
+#define HASH_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "pool.h"
+
+/**
+ * Open addressing (linear probing) hash table of key:data elements.
+ * Used by the map for constant time point operations. Ordered access is given by a sorted index
+ * of the table which is built on demand and invalidated whenever a key is added or removed.
+ * Copies of a table which is not inline share its keys and data (copy on write): an element is copied
+ * only when one of the tables accesses it with hashTableFindForWrite, and is freed by the last table using it.
+*/
+
+typedef void* HashKeyElement;
+typedef void* HashDataElement;
+
+typedef HashDataElement (*copyHashDataElement)(HashDataElement);
+typedef HashKeyElement (*copyHashKeyElement)(HashKeyElement);
+typedef void (*freeHashDataElement)(HashDataElement);
+typedef void (*freeHashKeyElement)(HashKeyElement);
+typedef int (*compareHashKeyElements)(HashKeyElement, HashKeyElement);
+typedef unsigned int (*hashHashKeyElement)(HashKeyElement);
+
+// an empty slot is marked by a NULL key.
+struct hash_entry_t {
+    HashKeyElement key;
+    HashDataElement data;
+    unsigned int hash;
+    struct hash_element_t *element;  // NULL unless the key and data are shared with copies of the table
+};
+
+typedef struct hash_entry_t *HashEntry;
+
+typedef struct hash_table_t *HashTable;
+
+typedef enum {
+    HASH_TABLE_SUCCESS, HASH_TABLE_OUT_OF_MEMORY, HASH_TABLE_NULL_ARGUMENT, HASH_TABLE_ITEM_DOES_NOT_EXIST
+} HashTableError;
+
+// creates a new empty table. returns NULL if one of the arguments is NULL or on memory allocation error.
+HashTable hashTableCreate(copyHashDataElement copyData, copyHashKeyElement copyKey,
+                          freeHashDataElement freeData, freeHashKeyElement freeKey,
+                          compareHashKeyElements compare, hashHashKeyElement hash);
+
+// creates a new empty table whose keys and data are stored inside its slots. keys are key_size bytes and data
+// are data_size bytes, and both are copied with memcpy. returns NULL if key_size is 0, if compare or hash are NULL
+// or on memory allocation error.
+HashTable hashTableCreateInline(size_t key_size, size_t data_size,
+                                compareHashKeyElements compare, hashHashKeyElement hash);
+
+// frees all the elements of the table (using the free functions), then frees the table.
+void hashTableDestroy(HashTable table);
+
+// returns a copy of the table. the copy of a table which is not inline shares the keys and data of the table,
+// and takes O(n) without calling the copy functions. returns NULL on memory allocation error.
+HashTable hashTableCopy(HashTable table);
+
+// returns the amount of elements in the table, or -1 if table is NULL.
+int hashTableGetSize(HashTable table);
+
+// returns the entry whose key equals key (NOT a copy), or NULL if there is no such entry.
+// the data of the entry must not be changed, since it may be shared with copies of the table.
+HashEntry hashTableFind(HashTable table, HashKeyElement key);
+
+// same as hashTableFind, but first makes the key and data of the entry private to table, so its data may be
+// changed. returns NULL if there is no such entry or on memory allocation error.
+HashEntry hashTableFindForWrite(HashTable table, HashKeyElement key);
+
+// inserts a copy of key and data into the table. if the key exists only its data is replaced.
+HashTableError hashTablePut(HashTable table, HashKeyElement key, HashDataElement data);
+
+// same as hashTablePut, but the table takes ownership of key and data instead of copying them. if the key exists,
+// the given key is freed. table must not be inline. on failure key and data are not taken.
+HashTableError hashTablePutTake(HashTable table, HashKeyElement key, HashDataElement data);
+
+// removes and frees the element whose key equals key.
+HashTableError hashTableRemove(HashTable table, HashKeyElement key);
+
+// removes and frees all the elements of the table.
+void hashTableClear(HashTable table);
+
+/**
+ * hashTableSort: builds the sorted index of the table if it is not up to date, which takes O(n log n).
+ * hashTableGetSorted can not fail after it, until a key is added or removed.
+ *
+ * @return
+ *   false if table is NULL or on memory allocation error. true otherwise.
+*/
+bool hashTableSort(HashTable table);
+
+/**
+ * hashTableGetSorted: returns the entry with the index-th smallest key. builds the sorted index of the table
+ * if it is not up to date, which takes O(n log n). after that each call is O(1).
+ *
+ * @return
+ *   NULL if index is out of range or if building the sorted index failed. the entry otherwise.
+*/
+HashEntry hashTableGetSorted(HashTable table, int index);
+
+/**
+ * hashTableGetSortedBound: returns the index (as used by hashTableGetSorted) of the smallest key which is greater
+ * than key if strict is true, or greater than or equal to key otherwise. uses a binary search over the sorted
+ * index, which is built first if it is not up to date.
+ *
+ * @return
+ *   -1 if table or key is NULL or if building the sorted index failed. the size of the table if there is no
+ *   such key. the index otherwise.
+*/
+int hashTableGetSortedBound(HashTable table, HashKeyElement key, bool strict);
+
+/**
+ * hashTableNextSlot: returns the index of the first slot at or after slot which holds an entry. walks the slots of
+ * the table in their own order, without the sorted index, so it can not fail.
+ *
+ * @return
+ *   -1 if table is NULL or there is no such slot. the index of the slot otherwise.
+*/
+int hashTableNextSlot(HashTable table, int slot);
+
+// returns the entry of the slot-th slot (NOT a copy), or NULL if the slot is empty or out of range.
+HashEntry hashTableGetSlot(HashTable table, int slot);
+
+#endif
@@ -1,17 +1,20 @@
 #include <stdlib.h>
 #include "list.h"
 
-/** TODO:
- * listGetSize: always returns at least 1 which is a problem. is it more correct to count data elements?
- * other wise we could implement a dummy node. either way it will change implementation of the whole project.
- * remove - needs to be implemented in tournament.c since we can't compare data elements here.
- * or can we? no it is best from outside.
- * contains - same problem.
+/**
+ * a list always has at least one node. an empty list is a single node whose data is NULL, so listGetSize counts
+ * nodes and not data elements, and callers tell an empty list apart by the data of its first node.
+ * all the nodes of a list share one counter, which keeps listGetSize O(1).
+ * the data elements are opaque here, so removing or finding a node by its data is done by the callers, which know
+ * how to compare it. listRemoveNext and listRemoveFirst unlink a node whose position they already found.
 */
 
-List listCreate(freeListDataElement freeData, copyListDataElement copyData)
+// HELPER FUNCTIONS START
+
+// creates a new node which belongs to the list whose size is size, and counts it.
+static List listCreateNode(freeListDataElement freeData, copyListDataElement copyData, int* size, Pool pool)
 {
-    List list = malloc(sizeof(*list));
+    List list = pool == NULL ? malloc(sizeof(*list)) : poolAlloc(pool);
     if(list == NULL)
     {
         return NULL;
@@ -20,6 +23,52 @@ List listCreate(freeListDataElement freeData, copyListDataElement copyData)
     list->copyDataElement = copyData;
     list->data = NULL;
     list->next = NULL;
+    list->size = size;
+    list->pool = pool;
+    (*size)++;
+    return list;
+}
+
+// frees a single node and its data, and uncounts it. frees the size counter with the last node.
+static void listDestroyNode(List list)
+{
+    list->freeDataElement(list->data);
+    (*list->size)--;
+    if(*list->size == 0)
+    {
+        free(list->size);
+    }
+    if(list->pool == NULL)
+    {
+        free(list);
+    }
+    else
+    {
+        poolFree(list->pool, list);
+    }
+}
+
+// HELPER FUNCTIONS END
+
+List listCreate(freeListDataElement freeData, copyListDataElement copyData)
+{
+    return listCreatePooled(freeData, copyData, NULL);
+}
+
+List listCreatePooled(freeListDataElement freeData, copyListDataElement copyData, Pool pool)
+{
+    int* size = malloc(sizeof(*size));
+    if(size == NULL)
+    {
+        return NULL;
+    }
+    *size = 0;
+    List list = listCreateNode(freeData, copyData, size, pool);
+    if(list == NULL)
+    {
+        free(size);
+        return NULL;
+    }
     return list;
 }
 
@@ -45,14 +94,11 @@ dataElement listGetData(List list)
 
 int listGetSize(List list)
 {
-    List iterator = list;
-    int counter = 0;
-    while(iterator)
+    if(list == NULL)
     {
-        counter++;
-        iterator = iterator->next;
+        return 0;
     }
-    return counter;
+    return *list->size;
 }
 
 ListError listCopy(List src, List dest)
@@ -63,17 +109,15 @@ ListError listCopy(List src, List dest)
     }
 
     List iterator = src;
-    List head = dest;
     while(iterator)
     {
         src->freeDataElement(dest->data);  // making sure no memory leaks
         dest->data = src->copyDataElement(iterator->data);
         if(iterator->next)
         {
-            dest->next = listCreate(src->freeDataElement, src->copyDataElement);
+            dest->next = listCreateNode(src->freeDataElement, src->copyDataElement, dest->size, dest->pool);
             if(dest->next == NULL)
             {
-                listDestroy(head);
                 return LIST_MEMORY_ERROR;
             }
             dest = dest->next;
@@ -93,12 +137,11 @@ List listAdd(List list)
     {
         return list;
     }
-    List new_list = listCreate(list->freeDataElement, list->copyDataElement);
+    List new_list = listCreateNode(list->freeDataElement, list->copyDataElement, list->size, list->pool);
     if(new_list == NULL)
     {
         return NULL;
     }
-    new_list->data = NULL;
     new_list->next = list->next;
     list->next = new_list;
     return new_list;
@@ -113,8 +156,30 @@ void listDestroy(List list)
     while(list)
     {
         List temp = list;
-        list->freeDataElement(list->data);
         list = list->next;
-        free(temp);
+        listDestroyNode(temp);
+    }
+}
+
+ListError listRemoveNext(List list)
+{
+    if(list == NULL || list->next == NULL)
+    {
+        return LIST_NULL_ARGUMENT;
+    }
+    List temp = list->next;
+    list->next = temp->next;
+    listDestroyNode(temp);
+    return LIST_SUCCESS;
+}
+
+List listRemoveFirst(List list)
+{
+    if(list == NULL)
+    {
+        return NULL;
     }
+    List next = list->next;
+    listDestroyNode(list);
+    return next;
 }
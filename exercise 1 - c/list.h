@@ -1,6 +1,8 @@
 #ifndef LIST_H
 #define LIST_H
 
+#include "pool.h"
+
 typedef void* dataElement;
 
 typedef void (*freeListDataElement)(dataElement);
@@ -11,6 +13,8 @@ struct list_t {
     freeListDataElement freeDataElement;
     copyListDataElement copyDataElement;
     struct list_t *next;
+    int *size;  // amount of nodes in the list, shared by all of its nodes
+    Pool pool;  // the nodes of the list are allocated from pool, or with malloc if it is NULL
 };
 
 typedef struct list_t *List;
@@ -22,23 +26,32 @@ typedef enum {
 // creates a new list node. returns NULL on memory allocation error.
 List listCreate(freeListDataElement freeData, copyListDataElement copyData);
 
-// sets data value of a given list. returns LIST_NULL_ARGUMENT if list is NULL.
+// creates a new list node whose nodes are allocated from pool. the pool must outlive the list.
+// returns NULL on memory allocation error.
+List listCreatePooled(freeListDataElement freeData, copyListDataElement copyData, Pool pool);
+
+// sets data value of a given list, which takes ownership of data (it is not copied).
+// returns LIST_NULL_ARGUMENT if list is NULL.
 ListError listSet(List list, dataElement data);
 
 // returns the data element of given list (NOT a copy).
 dataElement listGetData(List list);
 
-// returns a copy of a given list. returns NULL if the list is empty or if there
-// was a memory allocation error.
+// copies the nodes of src into dest, which must be a single node. returns LIST_MEMORY_ERROR if there
+// was a memory allocation error, in which case dest holds part of the nodes and should be destroyed.
 ListError listCopy(List src, List dest);
 
 // adds another list after list
 List listAdd(List list);
 
-// returns the amount of nodes in the list.
+// returns the amount of nodes in the list the given node belongs to. takes O(1).
 int listGetSize(List list);
 
-// ListError listDelete(List list); //?
+// destroys the node after list. returns LIST_NULL_ARGUMENT if list or the node after it is NULL.
+ListError listRemoveNext(List list);
+
+// destroys the first node of a list and returns the next node, which is the new first node.
+List listRemoveFirst(List list);
 
 // destroys all nodes of a list, then frees the list.
 void listDestroy(List list);
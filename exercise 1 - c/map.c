@@ -1,83 +1,338 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include "map.h"
 #include "list.h"
 #include "pair.h"
+#include "tree.h"
+#include "hashTable.h"
+#include "pool.h"
+
+typedef enum {
+    MAP_BACKEND_LIST,
+    MAP_BACKEND_TREE,
+    MAP_BACKEND_HASH
+} MapBackend;
 
 struct Map_t {
-    List head;
+    MapBackend backend;
+    copyMapDataElements copyDataElement;
+    copyMapKeyElements copyKeyElement;
+    freeMapDataElements freeDataElement;
+    freeMapKeyElements freeKeyElement;
     compareMapKeyElements compareKeyElements;
+    List head;  // the list state is NULL unless the backend is the list
     List iterator;
+    Pool list_pool;  // the list nodes and pairs of the list backend are allocated from these pools
+    Pool pair_pool;
+    Tree tree;
+    TreeNode tree_iterator;
+    HashTable hash_table;
+    int hash_iterator;  // position in the sorted index of hash_table
+    size_t inline_key_size;  // 0 unless the tree or hash table stores the keys inside its nodes
 };
 
 // HELPER FUNCTIONS START
 
+// returns a copy of a key stored in the tree or the hash table of map. the copy of an inline key is malloced.
+static MapKeyElement mapCopyStoredKey(Map map, MapKeyElement key)
+{
+    if(map->inline_key_size == 0)
+    {
+        return map->copyKeyElement(key);
+    }
+    MapKeyElement copy = malloc(map->inline_key_size);
+    if(copy != NULL)
+    {
+        memcpy(copy, key, map->inline_key_size);
+    }
+    return copy;
+}
+
+// creates an empty pair with the map's copy and free functions, allocated from the map's pair pool.
+static Pair mapCreatePair(Map map)
+{
+    return pairCreatePooled(map->copyDataElement, map->copyKeyElement,
+                            map->freeDataElement, map->freeKeyElement, map->pair_pool);
+}
+
+// sets the key and data of pair, either copying them or taking ownership of them.
+static void mapSetPair(Pair pair, MapDataElement data, MapKeyElement key, bool take)
+{
+    if(take)
+    {
+        pairSetTake(pair, data, key);
+    }
+    else
+    {
+        pairSet(pair, data, key);
+    }
+}
+
 /**
-* mapAdd: adds a new key:data elements to map while keeping the map ordered.
-* assumes key does not exist in map.
+* mapAddAfter: adds a new key:data elements to a list map after the node previous.
+* assumes key does not exist in map, and that the map stays ordered.
 *
 * @param map - The map to add to.
+* @param previous - the node to add after, or NULL to add before the first element.
 * @param key - the key to add.
 * @param data - the data which is accociated to the key.
-* 		comparison function.
+* @param take - whether the map takes ownership of key and data instead of copying them.
+* 		if it fails to allocate memory they are not taken.
 * @return
 * 	MAP_OUT_OF_MEMORY - if fails to allocate memory.
 *   MAP_SUCCESS - the paired elements had been inserted successfully.
 */
-static MapResult mapAdd(Map map, MapKeyElement key, MapDataElement data)
+static MapResult mapAddAfter(Map map, List previous, MapKeyElement key, MapDataElement data, bool take)
 {
-    if(mapGetSize(map) == 0) // adding first element
+    if(mapIsEmpty(map)) // adding first element
     {
-        pairSet((Pair)(listGetData(map->head)), data, key);
+        mapSetPair((Pair)(listGetData(map->head)), data, key, take);
         return MAP_SUCCESS;
     }
 
     // there is a pair to add
-    Pair pair = pairCreate(((Pair)(listGetData(map->head)))->copyDataFunc, 
-                            ((Pair)(listGetData(map->head)))->copyKeyFunc,
-                            ((Pair)(listGetData(map->head)))->freeDataFunc, 
-                            ((Pair)(listGetData(map->head)))->freeKeyFunc);
+    Pair pair = mapCreatePair(map);
     if(pair == NULL)
     {
         return MAP_OUT_OF_MEMORY;
     }
-    // pairSet(pair, data, key);
+    if(listAdd(previous == NULL ? map->head : previous) == NULL)
+    {
+        pairFree(pair);
+        return MAP_OUT_OF_MEMORY;
+    }
+    if(previous == NULL)  // inserting before the first element
+    {
+        // moving the first pair to the new second node, so it is not copied.
+        listSet(map->head->next, listGetData(map->head));
+        map->head->data = pair;
+    }
+    else
+    {
+        listSet(previous->next, pair);
+    }
+    mapSetPair(pair, data, key, take);
+    return MAP_SUCCESS;
+}
 
-    // check if we need to insert before the first element
-    if(map->compareKeyElements(key, ((Pair)(listGetData(map->head)))->key) < 0)
+// adds a new key:data elements to a list map while keeping the map ordered. assumes key does not exist in map.
+static MapResult mapAdd(Map map, MapKeyElement key, MapDataElement data, bool take)
+{
+    List previous = NULL;
+    if(!mapIsEmpty(map) && map->compareKeyElements(key, ((Pair)(listGetData(map->head)))->key) > 0)
     {
-        if(listAdd(map->head) == NULL)
+        previous = map->head;
+        while(previous->next && map->compareKeyElements(key, ((Pair)(listGetData(previous->next)))->key) > 0)
         {
-            pairFree(pair);
-            return MAP_OUT_OF_MEMORY;
+            previous = previous->next;
         }
+    }
+    return mapAddAfter(map, previous, key, data, take);
+}
 
-        Pair current_data = pairCopy(listGetData(map->head));
-        listSet(map->head->next, current_data);
-        listSet(map->head, pair);
+// sorts indices[low, high) by the keys they point to in keys, using buffer as scratch space.
+// the sort is stable, so equal keys keep the order they were given in.
+static void mapSortBatch(Map map, MapKeyElement* keys, int* indices, int* buffer, int low, int high)
+{
+    if(high - low < 2)
+    {
+        return;
+    }
+    int middle = low + (high - low) / 2;
+    mapSortBatch(map, keys, indices, buffer, low, middle);
+    mapSortBatch(map, keys, indices, buffer, middle, high);
+    int left = low, right = middle, index = low;
+    while(left < middle && right < high)
+    {
+        if(map->compareKeyElements(keys[indices[left]], keys[indices[right]]) <= 0)
+        {
+            buffer[index++] = indices[left++];
+        }
+        else
+        {
+            buffer[index++] = indices[right++];
+        }
+    }
+    while(left < middle)
+    {
+        buffer[index++] = indices[left++];
+    }
+    while(right < high)
+    {
+        buffer[index++] = indices[right++];
+    }
+    memcpy(indices + low, buffer + low, sizeof(*indices) * (high - low));
+}
 
-        pairSet((Pair)(listGetData(map->head)), data, key);
-        return MAP_SUCCESS;
+// returns the first result of a batch which is not MAP_SUCCESS, or MAP_SUCCESS if there is none.
+static MapResult mapBatchResult(MapResult* results, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        if(results[i] != MAP_SUCCESS)
+        {
+            return results[i];
+        }
     }
+    return MAP_SUCCESS;
+}
 
-    List iterator = map->head;
-    while(iterator)
+static MapResult mapResultFromHashTableError(HashTableError error)
+{
+    switch(error)
+    {
+        case HASH_TABLE_SUCCESS:
+            return MAP_SUCCESS;
+        case HASH_TABLE_OUT_OF_MEMORY:
+            return MAP_OUT_OF_MEMORY;
+        case HASH_TABLE_NULL_ARGUMENT:
+            return MAP_NULL_ARGUMENT;
+        case HASH_TABLE_ITEM_DOES_NOT_EXIST:
+            return MAP_ITEM_DOES_NOT_EXIST;
+    }
+    return MAP_ERROR;
+}
+
+static MapResult mapResultFromTreeError(TreeError error)
+{
+    switch(error)
+    {
+        case TREE_SUCCESS:
+            return MAP_SUCCESS;
+        case TREE_OUT_OF_MEMORY:
+            return MAP_OUT_OF_MEMORY;
+        case TREE_NULL_ARGUMENT:
+            return MAP_NULL_ARGUMENT;
+        case TREE_ITEM_DOES_NOT_EXIST:
+            return MAP_ITEM_DOES_NOT_EXIST;
+    }
+    return MAP_ERROR;
+}
+
+// returns a copy of the key of the tree iterator, or NULL if the iterator reached the end.
+static MapKeyElement mapTreeIteratorKeyCopy(Map map)
+{
+    if(map->tree_iterator == NULL)
+    {
+        return NULL;
+    }
+    return mapCopyStoredKey(map, map->tree_iterator->key);
+}
+
+// returns a copy of the key at the hash iterator's position, or NULL if the iterator reached the end.
+static MapKeyElement mapHashIteratorKeyCopy(Map map)
+{
+    HashEntry entry = hashTableGetSorted(map->hash_table, map->hash_iterator);
+    if(entry == NULL)
     {
-        if(iterator->next == NULL || map->compareKeyElements(key, ((Pair)(listGetData(iterator->next)))->key) < 0)
+        return NULL;
+    }
+    return mapCopyStoredKey(map, entry->key);
+}
+
+// returns the pair an external iterator over a list map points to, or NULL if it reached the end.
+static Pair mapIterListPair(MapIterator* iterator)
+{
+    Pair pair = listGetData(iterator->node);
+    if(pair == NULL || pair->key == NULL)  // only an empty map has a node without a key
+    {
+        return NULL;
+    }
+    return pair;
+}
+
+/**
+* mapAllocate: allocates a map with the given functions and no backend. the caller creates the state of its backend,
+* so a tree or a hash map does not allocate the list state it never uses.
+*
+* @return
+* 	NULL on memory allocation error. the map otherwise.
+*/
+static Map mapAllocate(copyMapDataElements copyDataElement,
+                       copyMapKeyElements copyKeyElement,
+                       freeMapDataElements freeDataElement,
+                       freeMapKeyElements freeKeyElement,
+                       compareMapKeyElements compareKeyElements)
+{
+    Map map = malloc(sizeof(*map));
+    if(map == NULL)
+    {
+        return NULL;
+    }
+    map->copyDataElement = copyDataElement;
+    map->copyKeyElement = copyKeyElement;
+    map->freeDataElement = freeDataElement;
+    map->freeKeyElement = freeKeyElement;
+    map->compareKeyElements = compareKeyElements;
+    map->backend = MAP_BACKEND_LIST;
+    map->head = NULL;
+    map->iterator = NULL;
+    map->list_pool = NULL;
+    map->pair_pool = NULL;
+    map->tree = NULL;
+    map->tree_iterator = NULL;
+    map->hash_table = NULL;
+    map->hash_iterator = 0;
+    map->inline_key_size = 0;
+    return map;
+}
+
+// ends an external iterator which passed its largest key.
+static void mapIterCheckEnd(MapIterator* iterator)
+{
+    if(iterator->end == NULL)
+    {
+        return;
+    }
+    MapKeyElement key = mapIterKey(iterator);
+    if(key != NULL && iterator->map->compareKeyElements(key, iterator->end) > 0)
+    {
+        iterator->node = NULL;
+    }
+}
+
+// returns an external iterator set to the smallest key greater than key if strict is true, or greater than or
+// equal to key otherwise.
+static MapIterator mapIterSeek(Map map, MapKeyElement key, bool strict)
+{
+    MapIterator iterator = mapIterBegin(key == NULL ? NULL : map);  // without a key the iterator is at the end
+    iterator.map = map;
+    if(map == NULL || key == NULL)
+    {
+        return iterator;
+    }
+    switch(map->backend)
+    {
+        case MAP_BACKEND_LIST:
         {
-            if(listAdd(iterator) == NULL)
+            // the list has no index, so its keys are scanned until the bound.
+            while(iterator.node != NULL)
             {
-                pairFree(pair);
-                return MAP_OUT_OF_MEMORY;
+                Pair pair = mapIterListPair(&iterator);
+                int compare_result = pair == NULL ? 0 : map->compareKeyElements(pair->key, key);
+                if(pair == NULL || compare_result > 0 || (compare_result == 0 && strict == false))
+                {
+                    break;
+                }
+                iterator.node = ((List)(iterator.node))->next;
             }
-            listSet(iterator->next, pair);
-            pairSet((Pair)(iterator->next->data), data, key);
-            return MAP_SUCCESS;
+            break;
         }
-        iterator = iterator->next;
+        case MAP_BACKEND_TREE:
+            iterator.node = strict ? treeGetNext(map->tree, key) : treeLowerBound(map->tree, key);
+            break;
+        case MAP_BACKEND_HASH:
+            if(iterator.failed)  // mapIterBegin could not build the sorted index
+            {
+                break;
+            }
+            iterator.index = hashTableGetSortedBound(map->hash_table, key, strict);
+            iterator.node = hashTableGetSorted(map->hash_table, iterator.index);
+            break;
     }
-    return MAP_SUCCESS; // should never reach
+    return iterator;
 }
 // HELPER FUNCTIONS END
 
@@ -92,36 +347,135 @@ Map mapCreate(copyMapDataElements copyDataElement,
         return NULL;
     }
 
-    Map map = malloc(sizeof(*map));
+    Map map = mapAllocate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement, compareKeyElements);
     if(map == NULL)
     {
         return NULL;
     }
 
-    map->head = listCreate((freeListDataElement)&pairFree, (copyListDataElement)&pairCopy);
+    map->list_pool = poolCreate(sizeof(struct list_t));
+    map->pair_pool = poolCreate(sizeof(struct pair_t));
+    if(map->list_pool == NULL || map->pair_pool == NULL)
+    {
+        mapDestroy(map);
+        return NULL;
+    }
+
+    map->head = listCreatePooled((freeListDataElement)&pairFree, (copyListDataElement)&pairCopy, map->list_pool);
     if(map->head == NULL)
     {
         mapDestroy(map);
         return NULL;
     }
-    Pair pair = pairCreate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement);
+    Pair pair = pairCreatePooled(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement, map->pair_pool);
     if(pair == NULL)
     {
         mapDestroy(map);
         return NULL;
     }
-    ListError result = listSet(map->head, pair);
-    if(result != LIST_SUCCESS)
+    listSet(map->head, pair);
+
+    map->iterator = map->head;  // maybe mapGetFirst(map)
+
+    return map;
+}
+
+Map mapCreateTree(copyMapDataElements copyDataElement,
+                  copyMapKeyElements copyKeyElement,
+                  freeMapDataElements freeDataElement,
+                  freeMapKeyElements freeKeyElement,
+                  compareMapKeyElements compareKeyElements)
+{
+    if(!copyDataElement || !copyKeyElement || !freeDataElement || !freeKeyElement || !compareKeyElements)
     {
-        free(map);
-        pairFree(pair);
         return NULL;
     }
+    Map map = mapAllocate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement, compareKeyElements);
+    if(map == NULL)
+    {
+        return NULL;
+    }
+    map->tree = treeCreate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement, compareKeyElements);
+    if(map->tree == NULL)
+    {
+        mapDestroy(map);
+        return NULL;
+    }
+    map->backend = MAP_BACKEND_TREE;
+    return map;
+}
 
-    map->iterator = map->head;  // maybe mapGetFirst(map)
+Map mapCreateHash(copyMapDataElements copyDataElement,
+                  copyMapKeyElements copyKeyElement,
+                  freeMapDataElements freeDataElement,
+                  freeMapKeyElements freeKeyElement,
+                  compareMapKeyElements compareKeyElements,
+                  hashMapKeyElements hashKeyElement)
+{
+    if(!copyDataElement || !copyKeyElement || !freeDataElement || !freeKeyElement || !compareKeyElements ||
+       !hashKeyElement)
+    {
+        return NULL;
+    }
+    Map map = mapAllocate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement, compareKeyElements);
+    if(map == NULL)
+    {
+        return NULL;
+    }
+    map->hash_table = hashTableCreate(copyDataElement, copyKeyElement, freeDataElement, freeKeyElement,
+                                      compareKeyElements, hashKeyElement);
+    if(map->hash_table == NULL)
+    {
+        mapDestroy(map);
+        return NULL;
+    }
+    map->backend = MAP_BACKEND_HASH;
+    return map;
+}
 
-    map->compareKeyElements = compareKeyElements;
+Map mapCreateInline(size_t keySize, size_t dataSize, compareMapKeyElements compareKeyElements)
+{
+    if(keySize == 0 || compareKeyElements == NULL)
+    {
+        return NULL;
+    }
+    Map map = mapAllocate(NULL, NULL, NULL, NULL, compareKeyElements);
+    if(map == NULL)
+    {
+        return NULL;
+    }
+    map->tree = treeCreateInline(keySize, dataSize, compareKeyElements);
+    if(map->tree == NULL)
+    {
+        mapDestroy(map);
+        return NULL;
+    }
+    map->backend = MAP_BACKEND_TREE;
+    map->inline_key_size = keySize;
+    return map;
+}
 
+Map mapCreateInlineHash(size_t keySize, size_t dataSize,
+                        compareMapKeyElements compareKeyElements,
+                        hashMapKeyElements hashKeyElement)
+{
+    if(keySize == 0 || compareKeyElements == NULL || hashKeyElement == NULL)
+    {
+        return NULL;
+    }
+    Map map = mapAllocate(NULL, NULL, NULL, NULL, compareKeyElements);
+    if(map == NULL)
+    {
+        return NULL;
+    }
+    map->hash_table = hashTableCreateInline(keySize, dataSize, compareKeyElements, hashKeyElement);
+    if(map->hash_table == NULL)
+    {
+        mapDestroy(map);
+        return NULL;
+    }
+    map->backend = MAP_BACKEND_HASH;
+    map->inline_key_size = keySize;
     return map;
 }
 
@@ -132,6 +486,11 @@ void mapDestroy(Map map)
         return;
     }
     listDestroy(map->head);
+    treeDestroy(map->tree);
+    hashTableDestroy(map->hash_table);
+    // all the list nodes and pairs were freed into the pools, the pools free them at once.
+    poolDestroy(map->list_pool);
+    poolDestroy(map->pair_pool);
     free(map);
 }
 
@@ -141,26 +500,57 @@ Map mapCopy(Map map)
     {
         return NULL;
     }
-    Map new_map = mapCreate(((Pair)(listGetData(map->head)))->copyDataFunc, 
-                            ((Pair)(listGetData(map->head)))->copyKeyFunc, 
-                            ((Pair)(listGetData(map->head)))->freeDataFunc, 
-                            ((Pair)(listGetData(map->head)))->freeKeyFunc, 
-                            map->compareKeyElements);
-    if(new_map == NULL)
+    if(map->backend == MAP_BACKEND_TREE || map->backend == MAP_BACKEND_HASH)
     {
-        return NULL;
+        Map new_map = mapAllocate(map->copyDataElement, map->copyKeyElement, map->freeDataElement,
+                                  map->freeKeyElement, map->compareKeyElements);
+        if(new_map == NULL)
+        {
+            return NULL;
+        }
+        if(map->backend == MAP_BACKEND_TREE)
+        {
+            new_map->tree = treeCopy(map->tree);
+        }
+        else
+        {
+            new_map->hash_table = hashTableCopy(map->hash_table);
+        }
+        if(new_map->tree == NULL && new_map->hash_table == NULL)
+        {
+            mapDestroy(new_map);
+            return NULL;
+        }
+        new_map->backend = map->backend;
+        new_map->inline_key_size = map->inline_key_size;
+        return new_map;
     }
-    ListError result = listCopy(map->head, new_map->head);
-    if(result == LIST_MEMORY_ERROR)
+    Map new_map = mapCreate(map->copyDataElement, map->copyKeyElement, map->freeDataElement,
+                            map->freeKeyElement, map->compareKeyElements);
+    if(new_map == NULL)
     {
         return NULL;
     }
-    if(new_map->head == NULL)  // neccessary?
+    // copying pair by pair (and not with listCopy), so the new pairs are allocated from the new map's pool.
+    List iterator = map->head;
+    List new_iterator = new_map->head;
+    while(iterator && ((Pair)(listGetData(iterator)))->key)
     {
-        mapDestroy(new_map);
-        return NULL;
-    }   
-    new_map->compareKeyElements = map->compareKeyElements;
+        if(iterator != map->head)
+        {
+            new_iterator = listAdd(new_iterator);
+            Pair new_pair = new_iterator == NULL ? NULL : mapCreatePair(new_map);
+            if(new_pair == NULL)
+            {
+                mapDestroy(new_map);
+                return NULL;
+            }
+            listSet(new_iterator, new_pair);
+        }
+        Pair pair = listGetData(iterator);
+        pairSet((Pair)(listGetData(new_iterator)), pair->data, pair->key);
+        iterator = iterator->next;
+    }
     return new_map;
 }
 
@@ -170,24 +560,40 @@ int mapGetSize(Map map)
     {
         return -1;
     }
-    int counter = 0;
-    List iterator = map->head;
-
-    // counting keys
-    while(iterator != NULL && listGetData(iterator) != NULL && ((Pair)(listGetData(iterator)))->key != NULL)
+    if(map->backend == MAP_BACKEND_TREE)
     {
-        counter++;
-        iterator = iterator->next;
+        return treeGetSize(map->tree);
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        return hashTableGetSize(map->hash_table);
+    }
+    if(((Pair)(listGetData(map->head)))->key == NULL)  // only the first node of an empty map has no key
+    {
+        return 0;
     }
-    return counter;
+    return listGetSize(map->head);
+}
+
+bool mapIsEmpty(Map map)
+{
+    return mapGetSize(map) <= 0;
 }
 
 bool mapContains(Map map, MapKeyElement element)
 {
-    if(map == NULL || element == NULL || map->head->data == NULL /*empty list*/)
+    if(map == NULL || element == NULL)
     {
         return false;
     }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        return treeFind(map->tree, element) != NULL;
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        return hashTableFind(map->hash_table, element) != NULL;
+    }
     if(mapGet(map, element) != NULL)
     {
         return true;
@@ -202,6 +608,14 @@ MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement)
     {
         return MAP_NULL_ARGUMENT;
     }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        return mapResultFromTreeError(treePut(map->tree, keyElement, dataElement));
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        return mapResultFromHashTableError(hashTablePut(map->hash_table, keyElement, dataElement));
+    }
     // search for existing key
     List iterator = map->head;
     while(iterator && ((Pair)listGetData(iterator))->key)  // while there are keys to search for
@@ -214,15 +628,140 @@ MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement)
         iterator = iterator->next;
     }
     // didn't found, need to add a new key
-    return mapAdd(map, keyElement, dataElement);
+    return mapAdd(map, keyElement, dataElement, false);
 }
 
-MapDataElement mapGet(Map map, MapKeyElement keyElement)
+MapResult mapPutTake(Map map, MapKeyElement keyElement, MapDataElement dataElement)
+{
+    if(map == NULL || keyElement == NULL || dataElement == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if(map->inline_key_size != 0)
+    {
+        return MAP_ERROR;
+    }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        return mapResultFromTreeError(treePutTake(map->tree, keyElement, dataElement));
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        return mapResultFromHashTableError(hashTablePutTake(map->hash_table, keyElement, dataElement));
+    }
+    List iterator = map->head;
+    while(iterator && ((Pair)listGetData(iterator))->key)
+    {
+        if(map->compareKeyElements(((Pair)listGetData(iterator))->key, keyElement) == 0)
+        {
+            pairSetTake((Pair)(listGetData(iterator)), dataElement, keyElement);
+            return MAP_SUCCESS;
+        }
+        iterator = iterator->next;
+    }
+    return mapAdd(map, keyElement, dataElement, true);
+}
+
+MapResult mapPutBatch(Map map, MapKeyElement* keyElements, MapDataElement* dataElements, int count,
+                      MapResult* results)
+{
+    if(map == NULL || keyElements == NULL || dataElements == NULL || results == NULL || count < 0)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    if(count == 0)
+    {
+        return MAP_SUCCESS;
+    }
+    if(map->backend != MAP_BACKEND_LIST)  // a tree or a hash table gains nothing from a sorted batch
+    {
+        for(int i = 0; i < count; i++)
+        {
+            results[i] = mapPut(map, keyElements[i], dataElements[i]);
+        }
+        return mapBatchResult(results, count);
+    }
+    int* indices = malloc(sizeof(*indices) * count * 2);
+    if(indices == NULL)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            results[i] = MAP_OUT_OF_MEMORY;
+        }
+        return MAP_OUT_OF_MEMORY;
+    }
+    int* buffer = indices + count;
+    int valid_count = 0;
+    for(int i = 0; i < count; i++)
+    {
+        if(keyElements[i] == NULL || dataElements[i] == NULL)
+        {
+            results[i] = MAP_NULL_ARGUMENT;
+        }
+        else
+        {
+            indices[valid_count++] = i;
+        }
+    }
+    mapSortBatch(map, keyElements, indices, buffer, 0, valid_count);
+
+    // merging the sorted batch into the list in a single pass. iterator is the first node whose key is not
+    // smaller than the current key, and previous is the node before it.
+    List previous = NULL;
+    List iterator = map->head;
+    for(int j = 0; j < valid_count; j++)
+    {
+        int i = indices[j];
+        while(iterator && ((Pair)listGetData(iterator))->key &&
+              map->compareKeyElements(((Pair)listGetData(iterator))->key, keyElements[i]) < 0)
+        {
+            previous = iterator;
+            iterator = iterator->next;
+        }
+        if(iterator && ((Pair)listGetData(iterator))->key &&
+           map->compareKeyElements(((Pair)listGetData(iterator))->key, keyElements[i]) == 0)
+        {
+            pairSet((Pair)(listGetData(iterator)), dataElements[i], keyElements[i]);
+            results[i] = MAP_SUCCESS;
+            continue;
+        }
+        results[i] = mapAddAfter(map, previous, keyElements[i], dataElements[i], false);
+        if(results[i] == MAP_SUCCESS)  // the new node is now the first node whose key is not smaller
+        {
+            iterator = (previous == NULL) ? map->head : previous->next;
+        }
+    }
+    free(indices);
+    return mapBatchResult(results, count);
+}
+
+// returns the data paired to keyElement. if for_write is true, data shared with copies of the map is copied first.
+static MapDataElement mapFind(Map map, MapKeyElement keyElement, bool for_write)
 {
-    if(map == NULL || keyElement == NULL || mapGetSize(map) == 0)
+    if(map == NULL || keyElement == NULL || mapIsEmpty(map))
     {
         return NULL;
     }
+    if(map->backend == MAP_BACKEND_TREE && for_write && treeIsShared(map->tree))
+    {
+        TreeNode node = treeFindForWrite(map->tree, keyElement);
+        if(map->tree_iterator != NULL)  // the node of the iterator may have been replaced by a copy
+        {
+            map->tree_iterator = treeFind(map->tree, map->tree_iterator->key);
+        }
+        return node == NULL ? NULL : node->data;
+    }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        TreeNode node = treeFind(map->tree, keyElement);
+        return node == NULL ? NULL : node->data;
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        HashEntry entry = for_write ? hashTableFindForWrite(map->hash_table, keyElement) :
+                                      hashTableFind(map->hash_table, keyElement);
+        return entry == NULL ? NULL : entry->data;
+    }
     List iterator = map->head;
     while(iterator)
     {
@@ -235,12 +774,30 @@ MapDataElement mapGet(Map map, MapKeyElement keyElement)
     return NULL;
 }
 
+MapDataElement mapGet(Map map, MapKeyElement keyElement)
+{
+    return mapFind(map, keyElement, true);
+}
+
+MapDataElement mapPeek(Map map, MapKeyElement keyElement)
+{
+    return mapFind(map, keyElement, false);
+}
+
 MapResult mapRemove(Map map, MapKeyElement keyElement)
 {
     if(map == NULL || keyElement == NULL)
     {
         return MAP_NULL_ARGUMENT;
     }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        return mapResultFromTreeError(treeRemove(map->tree, keyElement));
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        return mapResultFromHashTableError(hashTableRemove(map->hash_table, keyElement));
+    }
     MapDataElement first_key = mapGetFirst(map);
     if(first_key == NULL) // no keys in map
     {
@@ -251,10 +808,7 @@ MapResult mapRemove(Map map, MapKeyElement keyElement)
     {
         if(listGetSize(map->head) > 1) // list has at least two elements - switch heads.
         {
-            map->head->freeDataElement(listGetData(map->head));
-            List temp = map->head;
-            map->head = map->head->next;
-            free(temp);
+            map->head = listRemoveFirst(map->head);
         }
         else
         {
@@ -270,10 +824,7 @@ MapResult mapRemove(Map map, MapKeyElement keyElement)
     {
         if(map->compareKeyElements((((Pair)(listGetData(iterator->next)))->key), keyElement) == 0)
         {
-            List temp = iterator->next;
-            map->head->freeDataElement((Pair)(temp->data));
-            iterator->next = temp->next;
-            free(temp);
+            listRemoveNext(iterator);
             return MAP_SUCCESS;
         }
         iterator = iterator->next;
@@ -283,16 +834,44 @@ MapResult mapRemove(Map map, MapKeyElement keyElement)
 
 MapKeyElement mapGetFirst(Map map)
 {
-    if(map->head == NULL)
+    if(map == NULL)
     {
         return NULL;
     }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        map->tree_iterator = treeGetFirst(map->tree);
+        return mapTreeIteratorKeyCopy(map);
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        map->hash_iterator = 0;
+        return mapHashIteratorKeyCopy(map);
+    }
     map->iterator = map->head;
     return ((Pair)(listGetData(map->iterator)))->copyKeyFunc(((Pair)(listGetData(map->iterator)))->key);
 }
 
 MapKeyElement mapGetNext(Map map)
 {
+    if(map == NULL)
+    {
+        return NULL;
+    }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        if(map->tree_iterator == NULL)
+        {
+            return NULL;
+        }
+        map->tree_iterator = treeGetNext(map->tree, map->tree_iterator->key);
+        return mapTreeIteratorKeyCopy(map);
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        map->hash_iterator++;
+        return mapHashIteratorKeyCopy(map);
+    }
     if(map->iterator->next == NULL)
     {
         return NULL;
@@ -307,7 +886,226 @@ MapResult mapClear(Map map)
     {
         return MAP_NULL_ARGUMENT;
     }
+    if(map->backend == MAP_BACKEND_TREE)
+    {
+        treeClear(map->tree);
+        map->tree_iterator = NULL;
+        return MAP_SUCCESS;
+    }
+    if(map->backend == MAP_BACKEND_HASH)
+    {
+        hashTableClear(map->hash_table);
+        return MAP_SUCCESS;
+    }
     listDestroy(map->head->next);
+    map->head->next = NULL;
     pairSet((Pair)listGetData(map->head), NULL, NULL);  // need to keep first pair
     return MAP_SUCCESS;
-}
\ No newline at end of file
+}
+
+MapIterator mapIterBegin(Map map)
+{
+    MapIterator iterator;
+    iterator.map = map;
+    iterator.node = NULL;
+    iterator.index = 0;
+    iterator.failed = false;
+    iterator.unordered = false;
+    iterator.end = NULL;
+    if(map == NULL)
+    {
+        return iterator;
+    }
+    switch(map->backend)
+    {
+        case MAP_BACKEND_LIST:
+            iterator.node = map->head;
+            break;
+        case MAP_BACKEND_TREE:
+            iterator.node = treeGetFirst(map->tree);
+            break;
+        case MAP_BACKEND_HASH:
+            // the sorted index is built here, so the rest of the iteration can not fail.
+            iterator.failed = !hashTableSort(map->hash_table);
+            iterator.node = iterator.failed ? NULL : hashTableGetSorted(map->hash_table, 0);
+            break;
+    }
+    return iterator;
+}
+
+MapIterator mapIterBeginUnordered(Map map)
+{
+    if(map == NULL || map->backend != MAP_BACKEND_HASH)
+    {
+        return mapIterBegin(map);  // the other backends walk their keys in order without any allocation
+    }
+    MapIterator iterator = mapIterBegin(NULL);
+    iterator.map = map;
+    iterator.unordered = true;
+    iterator.index = hashTableNextSlot(map->hash_table, 0);
+    iterator.node = hashTableGetSlot(map->hash_table, iterator.index);
+    return iterator;
+}
+
+void mapIterNext(MapIterator* iterator)
+{
+    if(iterator == NULL || iterator->node == NULL)
+    {
+        return;
+    }
+    switch(iterator->map->backend)
+    {
+        case MAP_BACKEND_LIST:
+            iterator->node = ((List)(iterator->node))->next;
+            break;
+        case MAP_BACKEND_TREE:
+            iterator->node = treeGetNext(iterator->map->tree, ((TreeNode)(iterator->node))->key);
+            break;
+        case MAP_BACKEND_HASH:
+            if(iterator->unordered)
+            {
+                iterator->index = hashTableNextSlot(iterator->map->hash_table, iterator->index + 1);
+                iterator->node = hashTableGetSlot(iterator->map->hash_table, iterator->index);
+                break;
+            }
+            iterator->index++;
+            iterator->node = hashTableGetSorted(iterator->map->hash_table, iterator->index);
+            break;
+    }
+    mapIterCheckEnd(iterator);
+}
+
+MapIterator mapLowerBound(Map map, MapKeyElement keyElement)
+{
+    return mapIterSeek(map, keyElement, false);
+}
+
+MapIterator mapUpperBound(Map map, MapKeyElement keyElement)
+{
+    return mapIterSeek(map, keyElement, true);
+}
+
+MapIterator mapIterRange(Map map, MapKeyElement lowKey, MapKeyElement highKey)
+{
+    MapIterator iterator = mapIterSeek(map, lowKey, false);
+    if(highKey == NULL)
+    {
+        iterator.node = NULL;
+        return iterator;
+    }
+    iterator.end = highKey;
+    mapIterCheckEnd(&iterator);
+    return iterator;
+}
+
+MapKeyElement mapIterKey(MapIterator* iterator)
+{
+    if(iterator == NULL || iterator->node == NULL)
+    {
+        return NULL;
+    }
+    switch(iterator->map->backend)
+    {
+        case MAP_BACKEND_LIST:
+        {
+            Pair pair = mapIterListPair(iterator);
+            return pair == NULL ? NULL : pair->key;
+        }
+        case MAP_BACKEND_TREE:
+            return ((TreeNode)(iterator->node))->key;
+        case MAP_BACKEND_HASH:
+            return ((HashEntry)(iterator->node))->key;
+    }
+    return NULL;
+}
+
+MapDataElement mapIterData(MapIterator* iterator)
+{
+    if(iterator == NULL || iterator->node == NULL)
+    {
+        return NULL;
+    }
+    switch(iterator->map->backend)
+    {
+        case MAP_BACKEND_LIST:
+            return mapIterPeek(iterator);
+        case MAP_BACKEND_TREE:
+        {
+            if(treeIsShared(iterator->map->tree) == false)
+            {
+                return ((TreeNode)(iterator->node))->data;
+            }
+            // the node is replaced by a private copy if it is shared with copies of the map.
+            TreeNode node = treeFindForWrite(iterator->map->tree, ((TreeNode)(iterator->node))->key);
+            iterator->node = node;
+            iterator->failed = node == NULL;
+            return node == NULL ? NULL : node->data;
+        }
+        case MAP_BACKEND_HASH:
+        {
+            HashEntry entry = iterator->node;
+            if(entry->element != NULL)  // shared with copies of the map
+            {
+                entry = hashTableFindForWrite(iterator->map->hash_table, entry->key);
+                iterator->failed = entry == NULL;
+                if(entry == NULL)
+                {
+                    iterator->node = NULL;
+                    return NULL;
+                }
+            }
+            return entry->data;
+        }
+    }
+    return NULL;
+}
+
+MapDataElement mapIterPeek(MapIterator* iterator)
+{
+    if(iterator == NULL || iterator->node == NULL)
+    {
+        return NULL;
+    }
+    switch(iterator->map->backend)
+    {
+        case MAP_BACKEND_LIST:
+        {
+            Pair pair = mapIterListPair(iterator);
+            return pair == NULL ? NULL : pair->data;
+        }
+        case MAP_BACKEND_TREE:
+            return ((TreeNode)(iterator->node))->data;
+        case MAP_BACKEND_HASH:
+            return ((HashEntry)(iterator->node))->data;
+    }
+    return NULL;
+}
+
+bool mapIterFailed(MapIterator* iterator)
+{
+    return iterator != NULL && iterator->failed;
+}
+
+MapResult mapGetAllocationStatistics(Map map, MapAllocationStatistics* statistics)
+{
+    if(map == NULL || statistics == NULL)
+    {
+        return MAP_NULL_ARGUMENT;
+    }
+    PoolStatistics pools[2] = {poolGetStatistics(NULL), poolGetStatistics(NULL)};
+    if(map->backend == MAP_BACKEND_LIST)
+    {
+        pools[0] = poolGetStatistics(map->list_pool);
+        pools[1] = poolGetStatistics(map->pair_pool);
+    }
+    else if(map->backend == MAP_BACKEND_TREE)
+    {
+        pools[0] = treeGetStatistics(map->tree);
+    }
+    statistics->blocks_in_use = pools[0].elements_in_use + pools[1].elements_in_use;
+    statistics->peak_blocks_in_use = pools[0].peak_elements_in_use + pools[1].peak_elements_in_use;
+    statistics->blocks_reserved = pools[0].elements_reserved + pools[1].elements_reserved;
+    statistics->slabs = pools[0].slabs + pools[1].slabs;
+    statistics->allocations = pools[0].allocations + pools[1].allocations;
+    return MAP_SUCCESS;
+}
@@ -2,6 +2,7 @@
 #define MAP_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
 * Generic Map Container
@@ -13,16 +14,27 @@
 *
 * The following functions are available:
 *   mapCreate		- Creates a new empty map
+*   mapCreateTree	- Creates a new empty map which is kept in a balanced tree
+*   mapCreateHash	- Creates a new empty map which is kept in a hash table
+*   mapCreateInline	- Creates a new empty tree map which stores fixed size keys and data
+*   				  inside its nodes
+*   mapCreateInlineHash - Creates a new empty hash map which stores fixed size keys and data
+*   				  inside its table
 *   mapDestroy		- Deletes an existing map and frees all resources
 *   mapCopy		- Copies an existing map
 *   mapGetSize		- Returns the size of a given map
+*   mapIsEmpty		- Returns weather or not a given map is empty
 *   mapContains	- returns weather or not a key exists inside the map.
 *   				  This resets the internal iterator.
 *   mapPut		    - Gives a specific key a given value.
 *   				  If the key exists, the value is overridden.
 *   				  This resets the internal iterator.
+*   mapPutTake	    - Same as mapPut, but the map takes ownership of the given key and
+*   				  value instead of copying them.
+*   mapPutBatch	- Puts an array of keys and values into the map at once.
 *   mapGet  	    - Returns the data paired to a key which matches the given key.
 *					  Iterator status unchanged
+*   mapPeek		- Returns the data paired to a key, for reading only.
 *   mapRemove		- Removes a pair of (key,data) elements for which the key
 *                    matches a given element (by the key compare function).
 *   				  This resets the internal iterator.
@@ -34,6 +46,21 @@
 *	 				  the map using the free function.
 * 	 MAP_FOREACH	- A macro for iterating over the map's elements, iterator needs to be deallocated (freed)
 *                     each iteration.
+*   mapIterBegin	- Returns an external iterator (cursor) set to the smallest key of the map
+*   mapIterBeginUnordered - Returns an external iterator over the keys of the map in no particular order
+*   mapIterNext	- Advances an external iterator to the next key
+*   mapLowerBound	- Returns an external iterator set to the smallest key not smaller than a given key
+*   mapUpperBound	- Returns an external iterator set to the smallest key greater than a given key
+*   mapIterRange	- Returns an external iterator over the keys between two given keys
+*   mapIterKey		- Returns the key an external iterator points to (NOT a copy)
+*   mapIterData	- Returns the data an external iterator points to (NOT a copy)
+*   mapIterPeek	- Returns the data an external iterator points to, for reading only
+*   mapIterFailed	- Returns whether an external iterator stopped because of a memory allocation error
+*   mapGetAllocationStatistics - Returns statistics about the internal allocations of the map
+* 	 MAP_ITER_FOREACH - A macro for iterating over the map's elements with an external iterator.
+*                     Nothing needs to be freed.
+* 	 MAP_RANGE_FOREACH - A macro for iterating over the map's elements whose keys are between two
+*                     given keys, with an external iterator.
 */
 
 /** Type for defining the map */
@@ -49,6 +76,36 @@ typedef enum MapResult_t {
     MAP_ITEM_DOES_NOT_EXIST
 } MapResult;
 
+/**
+* Type of an external iterator over a map. Unlike the internal iterator, any number of
+* external iterators can be used over the same map at once, and they hand out the keys and
+* data stored in the map instead of copies. The fields are for the map's internal use only.
+* An external iterator is invalid after an element is added to or removed from its map.
+* An iterator which stopped because of a memory allocation error is at the end, like an iterator
+* which finished; mapIterFailed tells them apart.
+*/
+typedef struct MapIterator_t {
+    struct Map_t *map;
+    void *node;
+    int index;
+    bool failed;  // a memory allocation error stopped the iterator
+    bool unordered;  // a hash map is walked in the order of its slots, and not of its sorted index
+    void *end;  // the largest key the iterator may reach, or NULL if it runs to the end of the map
+} MapIterator;
+
+/**
+* Statistics about the internal allocations of a map. A block is a single internal record of the
+* map (a list node, a pair or a tree node). Blocks are cut from slabs which are allocated with malloc,
+* and all of them are freed at once when the map is destroyed.
+*/
+typedef struct MapAllocationStatistics_t {
+    int blocks_in_use;
+    int peak_blocks_in_use;
+    int blocks_reserved;
+    int slabs;
+    long allocations;
+} MapAllocationStatistics;
+
 /** Data element data type for map container */
 typedef void *MapDataElement;
 
@@ -77,6 +134,12 @@ typedef void(*freeMapKeyElements)(MapKeyElement);
 */
 typedef int(*compareMapKeyElements)(MapKeyElement, MapKeyElement);
 
+/**
+* Type of function used by a hash map to hash key elements.
+* Key elements which are equal by the compare function must have the same hash.
+*/
+typedef unsigned int(*hashMapKeyElements)(MapKeyElement);
+
 /**
 * mapCreate: Allocates a new empty map.
 *
@@ -100,6 +163,99 @@ Map mapCreate(copyMapDataElements copyDataElement,
               freeMapKeyElements freeKeyElement,
               compareMapKeyElements compareKeyElements);
 
+/**
+* mapCreateTree: Allocates a new empty map which keeps its elements in a balanced
+* binary search tree instead of a linked list. The map is used through the same
+* functions as a map created by mapCreate, but mapContains, mapGet, mapPut and
+* mapRemove take O(log n) instead of O(n). Iteration is still by key order.
+*
+* @param copyDataElement - Function pointer to be used for copying data elements into
+*  	the map or when copying the map.
+* @param copyKeyElement - Function pointer to be used for copying key elements into
+*  	the map or when copying the map.
+* @param freeDataElement - Function pointer to be used for removing data elements from
+* 		the map
+* @param freeKeyElement - Function pointer to be used for removing key elements from
+* 		the map
+* @param compareKeyElements - Function pointer to be used for comparing key elements
+* 		inside the map. Used to check if new elements already exist in the map.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new Map in case of success.
+*/
+Map mapCreateTree(copyMapDataElements copyDataElement,
+                  copyMapKeyElements copyKeyElement,
+                  freeMapDataElements freeDataElement,
+                  freeMapKeyElements freeKeyElement,
+                  compareMapKeyElements compareKeyElements);
+
+/**
+* mapCreateHash: Allocates a new empty map which keeps its elements in an open addressing
+* hash table. The map is used through the same functions as a map created by mapCreate.
+* mapContains, mapGet, mapPut and mapRemove take O(1) on average.
+* mapGetFirst and mapGetNext still iterate by key order, using a sorted index of the keys.
+* The index is built by mapGetFirst after keys were added or removed, which takes O(n log n).
+*
+* @param copyDataElement - Function pointer to be used for copying data elements into
+*  	the map or when copying the map.
+* @param copyKeyElement - Function pointer to be used for copying key elements into
+*  	the map or when copying the map.
+* @param freeDataElement - Function pointer to be used for removing data elements from
+* 		the map
+* @param freeKeyElement - Function pointer to be used for removing key elements from
+* 		the map
+* @param compareKeyElements - Function pointer to be used for comparing key elements
+* 		inside the map. Used to check if new elements already exist in the map.
+* @param hashKeyElement - Function pointer to be used for hashing key elements.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new Map in case of success.
+*/
+Map mapCreateHash(copyMapDataElements copyDataElement,
+                  copyMapKeyElements copyKeyElement,
+                  freeMapDataElements freeDataElement,
+                  freeMapKeyElements freeKeyElement,
+                  compareMapKeyElements compareKeyElements,
+                  hashMapKeyElements hashKeyElement);
+
+/**
+* mapCreateInline: Allocates a new empty map like mapCreateTree, for keys and data of a fixed size
+* which can be copied byte by byte (for example int or double, or structs without pointers).
+* The keys and data are stored inside the tree nodes, so mapPut copies them with memcpy and no
+* allocation is made per element, and clearing or destroying the map frees all the nodes at once.
+* mapGet returns a pointer to the data inside the map, which is valid until the key is removed.
+* mapGetFirst and mapGetNext return a copy of the key which should be freed with free().
+*
+* @param keySize - The size in bytes of every key element.
+* @param dataSize - The size in bytes of every data element. May be 0.
+* @param compareKeyElements - Function pointer to be used for comparing key elements
+* 		inside the map. Used to check if new elements already exist in the map.
+* @return
+* 	NULL - if keySize is 0, compareKeyElements is NULL or allocations failed.
+* 	A new Map in case of success.
+*/
+Map mapCreateInline(size_t keySize, size_t dataSize, compareMapKeyElements compareKeyElements);
+
+/**
+* mapCreateInlineHash: Allocates a new empty map like mapCreateHash, which stores keys and data of
+* a fixed size inside its table, the same way mapCreateInline stores them inside tree nodes.
+* Unlike mapCreateInline, any mapPut or mapRemove on the map invalidates every pointer mapGet or
+* mapPeek returned before it, even for other keys: the elements are stored in the table's slots,
+* which all move when the table grows, and a removal shifts the slots after the removed one back.
+*
+* @param keySize - The size in bytes of every key element.
+* @param dataSize - The size in bytes of every data element. May be 0.
+* @param compareKeyElements - Function pointer to be used for comparing key elements
+* 		inside the map. Used to check if new elements already exist in the map.
+* @param hashKeyElement - Function pointer to be used for hashing key elements.
+* @return
+* 	NULL - if keySize is 0, one of the function pointers is NULL or allocations failed.
+* 	A new Map in case of success.
+*/
+Map mapCreateInlineHash(size_t keySize, size_t dataSize,
+                        compareMapKeyElements compareKeyElements,
+                        hashMapKeyElements hashKeyElement);
+
 /**
 * mapDestroy: Deallocates an existing map. Clears all elements by using the
 * stored free functions.
@@ -112,6 +268,13 @@ void mapDestroy(Map map);
 /**
 * mapCopy: Creates a copy of target map.
 * Iterator values for both maps is undefined after this operation.
+* Maps created by mapCreateTree, mapCreateHash and mapCreateInline are copied on write: the copy
+* shares the elements of map, and an element is copied only when one of the maps changes it, or
+* gets its data with mapGet or mapIterData. Copying a tree map takes O(1), and copying a hash map
+* takes O(n) without copying any element. Maps created by mapCreate and mapCreateInlineHash are
+* copied entirely.
+* Data elements which were got before the copy must not be changed through the old pointers after it,
+* and external iterators of a map should not be used after one of its copies is destroyed.
 *
 * @param map - Target map.
 * @return
@@ -121,7 +284,7 @@ void mapDestroy(Map map);
 Map mapCopy(Map map);
 
 /**
-* mapGetSize: Returns the number of elements in a map
+* mapGetSize: Returns the number of elements in a map. Takes O(1) for every backend.
 * @param map - The map which size is requested
 * @return
 * 	-1 if a NULL pointer was sent.
@@ -129,6 +292,15 @@ Map mapCopy(Map map);
 */
 int mapGetSize(Map map);
 
+/**
+* mapIsEmpty: Checks if a map has no elements. Takes O(1), like mapGetSize.
+* @param map - The map to check
+* @return
+* 	true - if map is NULL or has no elements.
+* 	false - otherwise.
+*/
+bool mapIsEmpty(Map map);
+
 /**
 * mapContains: Checks if a key element exists in the map. The key element will be
 * considered in the map if one of the key elements in the map it determined equal
@@ -161,6 +333,48 @@ bool mapContains(Map map, MapKeyElement element);
 */
 MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement);
 
+/**
+*	mapPutTake: Gives a specified key a specific value, like mapPut, without copying them.
+*  The map takes ownership of keyElement and dataElement, which must have been allocated so the
+*  free functions given at initialization can free them. If the key already exists, its old data
+*  is freed and keyElement is freed, since the map keeps its own key.
+*  Iterator's value is undefined after this operation.
+*
+* @param map - The map for which to reassign the data element
+* @param keyElement - The key element which need to be reassigned
+* @param dataElement - The new data element to associate with the given key.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map or keyElement or dataElement
+* 	MAP_ERROR if map was created by mapCreateInline or mapCreateInlineHash, which copy their elements
+* 	MAP_OUT_OF_MEMORY if an allocation failed
+* 	MAP_SUCCESS the paired elements had been inserted successfully
+* 	On failure the map does not take the elements, and the caller should free them.
+*/
+MapResult mapPutTake(Map map, MapKeyElement keyElement, MapDataElement dataElement);
+
+/**
+*	mapPutBatch: Puts count key:data elements into the map, the same as calling mapPut for each
+*  of them in order. The batch is sorted once and then merged into the map, so putting n
+*  elements into a map created by mapCreate takes O(n log n + size) instead of O(n * size).
+*  The other maps are not sorted for, and put the elements one by one.
+*  If a key appears more than once in the batch, its last data is the one kept.
+*  Iterator's value is undefined after this operation.
+*
+* @param map - The map to put the elements into
+* @param keyElements - An array of count key elements.
+* @param dataElements - An array of count data elements. dataElements[i] is associated with keyElements[i].
+* @param count - The amount of elements to put.
+* @param results - An array of count results, results[i] is set to the result of putting the i-th
+*      element, as mapPut would return it.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent as map or one of the arrays, or count is negative.
+* 	   In that case results is not changed.
+* 	MAP_SUCCESS if all the elements had been inserted successfully
+* 	The first result in results which is not MAP_SUCCESS otherwise.
+*/
+MapResult mapPutBatch(Map map, MapKeyElement* keyElements, MapDataElement* dataElements, int count,
+                      MapResult* results);
+
 /**
 *	mapGet: Returns the data associated with a specific key in the map.
 *			Iterator status unchanged
@@ -170,10 +384,17 @@ MapResult mapPut(Map map, MapKeyElement keyElement, MapDataElement dataElement);
 we want to get.
 * @return
 *  NULL if a NULL pointer was sent or if the map does not contain the requested key.
+*  NULL also if the data was shared with a copy of the map and copying it failed.
 * 	The data element associated with the key otherwise.
 */
 MapDataElement mapGet(Map map, MapKeyElement keyElement);
 
+/**
+*	mapPeek: Same as mapGet, but the returned data element must not be changed. Unlike mapGet,
+*	data shared with copies of the map (see mapCopy) is not copied, so reading a copy costs nothing.
+*/
+MapDataElement mapPeek(Map map, MapKeyElement keyElement);
+
 /**
 * 	mapRemove: Removes a pair of key and data elements from the map. The elements
 *  are found using the comparison function given at initialization. Once found,
@@ -233,6 +454,131 @@ MapKeyElement mapGetNext(Map map);
 */
 MapResult mapClear(Map map);
 
+/**
+*	mapIterBegin: Returns an external iterator set to the smallest key element in the map.
+*	Does not change the internal iterator and does not copy anything. A hash map builds its
+*	sorted index first if keys were added or removed, which may fail (see mapIterFailed).
+*	Once the index is built, iterating can not fail until a key is added or removed.
+*
+* @param map - The map to iterate over.
+* @return
+* 	An iterator. If map is NULL or empty, or building the sorted index failed, the iterator
+* 	is already at the end, meaning mapIterKey returns NULL for it.
+*/
+MapIterator mapIterBegin(Map map);
+
+/**
+*	mapIterBeginUnordered: Returns an external iterator over all the key elements of the map, in no
+*	particular order. Continue with mapIterNext. Unlike mapIterBegin it never fails: a hash map is
+*	walked in the order of its table, without its sorted index. The other maps are walked in order,
+*	the same as with mapIterBegin.
+*
+* @param map - The map to iterate over.
+* @return
+* 	An iterator. If map is NULL or empty, the iterator is already at the end.
+*/
+MapIterator mapIterBeginUnordered(Map map);
+
+/**
+*	mapIterNext: Advances an external iterator to the next key element, which is the smallest key
+*	element that is greater than the current one.
+*
+* @param iterator - The iterator to advance. Nothing is done if it is NULL or at the end.
+*/
+void mapIterNext(MapIterator* iterator);
+
+/**
+*	mapLowerBound: Returns an external iterator set to the smallest key element in the map which
+*	is greater than or equal to keyElement. Continue with mapIterNext, which goes on to the end of the map.
+*	Maps created by mapCreateTree or mapCreateInline seek in O(log n). Hash maps seek in O(log n) using
+*	their sorted index, which is built first if keys were added or removed, which may fail (see
+*	mapIterFailed). Maps created by mapCreate scan their keys until the bound.
+*
+* @param map - The map to iterate over.
+* @param keyElement - The key to seek.
+* @return
+* 	An iterator. If map or keyElement is NULL, or there is no such key, the iterator is already at the end.
+*/
+MapIterator mapLowerBound(Map map, MapKeyElement keyElement);
+
+/**
+*	mapUpperBound: Same as mapLowerBound, but returns an external iterator set to the smallest key
+*	element in the map which is greater than keyElement.
+*/
+MapIterator mapUpperBound(Map map, MapKeyElement keyElement);
+
+/**
+*	mapIterRange: Returns an external iterator over the key elements of the map which are greater than
+*	or equal to lowKey and smaller than or equal to highKey, in order. The iterator seeks lowKey like
+*	mapLowerBound, and reaches its end after the last key which is not greater than highKey, so only the
+*	keys in the range are visited.
+*
+* @param map - The map to iterate over.
+* @param lowKey - The smallest key of the range.
+* @param highKey - The largest key of the range. It is not copied, and must stay valid while the
+* 		iterator is used.
+* @return
+* 	An iterator. If one of the arguments is NULL, or there are no keys in the range, the iterator is
+* 	already at the end.
+*/
+MapIterator mapIterRange(Map map, MapKeyElement lowKey, MapKeyElement highKey);
+
+/**
+*	mapIterKey: Returns the key element an external iterator points to. The key belongs to
+*	the map and must not be changed or freed.
+*
+* @param iterator - The iterator.
+* @return
+* 	NULL if iterator is NULL or reached the end of the map.
+* 	The key element otherwise.
+*/
+MapKeyElement mapIterKey(MapIterator* iterator);
+
+/**
+*	mapIterData: Returns the data element an external iterator points to. The data belongs to
+*	the map and must not be freed.
+*
+* @param iterator - The iterator.
+* @return
+* 	NULL if iterator is NULL or reached the end of the map.
+* 	NULL also if the data was shared with a copy of the map and copying it failed. The iterator
+* 	is then at the end and mapIterFailed returns true for it.
+* 	The data element otherwise.
+*/
+MapDataElement mapIterData(MapIterator* iterator);
+
+/**
+*	mapIterPeek: Same as mapIterData, but the returned data element must not be changed, so data
+*	shared with copies of the map is not copied.
+*/
+MapDataElement mapIterPeek(MapIterator* iterator);
+
+/**
+*	mapIterFailed: Checks if an external iterator is at the end because of a memory allocation error,
+*	either while building the sorted index of a hash map, or while mapIterData copied shared data,
+*	and not because it passed its last key. Check it once mapIterKey returns NULL, or right after
+*	mapIterBegin, so a failed iteration is not mistaken for an empty map or a finished iteration.
+*
+* @param iterator - The iterator.
+* @return
+* 	true if a memory allocation error stopped the iterator.
+* 	false if iterator is NULL or it did not fail.
+*/
+bool mapIterFailed(MapIterator* iterator);
+
+/**
+*	mapGetAllocationStatistics: Returns statistics about the internal allocations of a map.
+*	Maps created by mapCreateHash keep their elements in a single array and report only zeros.
+*	The allocations of the key and data elements themselves (by the copy functions) are not counted.
+*
+* @param map - The map.
+* @param statistics - The statistics are written here.
+* @return
+* 	MAP_NULL_ARGUMENT if a NULL was sent.
+* 	MAP_SUCCESS otherwise.
+*/
+MapResult mapGetAllocationStatistics(Map map, MapAllocationStatistics* statistics);
+
 /*!
 * Macro for iterating over a map.
 * Declares a new iterator for the loop.
@@ -243,4 +589,23 @@ MapResult mapClear(Map map);
         iterator ;\
         iterator = mapGetNext(map))
 
+/*!
+* Macro for iterating over a map with an external iterator.
+* Declares a new MapIterator for the loop. Use mapIterKey(&iterator) and mapIterData(&iterator)
+* to access the current element. Nothing needs to be freed.
+*/
+#define MAP_ITER_FOREACH(iterator, map) \
+    for(MapIterator iterator = mapIterBegin(map) ; \
+        mapIterKey(&iterator) ; \
+        mapIterNext(&iterator))
+
+/*!
+* Macro for iterating over the elements of a map whose keys are between lowKey and highKey
+* (inclusive), with an external iterator, as MAP_ITER_FOREACH does.
+*/
+#define MAP_RANGE_FOREACH(iterator, map, lowKey, highKey) \
+    for(MapIterator iterator = mapIterRange(map, lowKey, highKey) ; \
+        mapIterKey(&iterator) ; \
+        mapIterNext(&iterator))
+
 #endif /* MAP_H_ */
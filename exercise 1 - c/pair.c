@@ -4,7 +4,13 @@
 Pair pairCreate(copyDataElement copyDataFunc, copyKeyElement copyKeyFunc, 
                 freeDataElement freeDataFunc, freeKeyElement freeKeyFunc)
 {
-    Pair pair = malloc(sizeof(*pair));
+    return pairCreatePooled(copyDataFunc, copyKeyFunc, freeDataFunc, freeKeyFunc, NULL);
+}
+
+Pair pairCreatePooled(copyDataElement copyDataFunc, copyKeyElement copyKeyFunc, 
+                      freeDataElement freeDataFunc, freeKeyElement freeKeyFunc, Pool pool)
+{
+    Pair pair = pool == NULL ? malloc(sizeof(*pair)) : poolAlloc(pool);
     if(pair == NULL)
     {
         return NULL;
@@ -15,6 +21,7 @@ Pair pairCreate(copyDataElement copyDataFunc, copyKeyElement copyKeyFunc,
     pair->copyKeyFunc = copyKeyFunc;
     pair->freeDataFunc = freeDataFunc;
     pair->freeKeyFunc = freeKeyFunc;
+    pair->pool = pool;
     return pair;
 }
 
@@ -31,6 +38,25 @@ PairErrors pairSet(Pair pair, PairDataElement data, PairKeyElement key)
     return PAIR_SUCCESS;
 }
 
+PairErrors pairSetTake(Pair pair, PairDataElement data, PairKeyElement key)
+{
+    if(pair == NULL)
+    {
+        return PAIR_NULL_ARGUMENT;
+    }
+    if(pair->data != data)
+    {
+        pair->freeDataFunc(pair->data);
+    }
+    if(pair->key != key)
+    {
+        pair->freeKeyFunc(pair->key);
+    }
+    pair->data = data;
+    pair->key = key;
+    return PAIR_SUCCESS;
+}
+
 void pairFree(Pair pair)
 {
     if(pair == NULL)
@@ -39,7 +65,14 @@ void pairFree(Pair pair)
     }
     pair->freeDataFunc(pair->data);
     pair->freeKeyFunc(pair->key);
-    free(pair);
+    if(pair->pool == NULL)
+    {
+        free(pair);
+    }
+    else
+    {
+        poolFree(pair->pool, pair);
+    }
 }
 
 Pair pairCopy(Pair pair)
@@ -48,7 +81,8 @@ Pair pairCopy(Pair pair)
     {
         return NULL;
     }
-    Pair new_pair = pairCreate(pair->copyDataFunc, pair->copyKeyFunc, pair->freeDataFunc, pair->freeKeyFunc);
+    Pair new_pair = pairCreatePooled(pair->copyDataFunc, pair->copyKeyFunc, pair->freeDataFunc, pair->freeKeyFunc,
+                                     pair->pool);
     if(new_pair == NULL)
     {
         return NULL;
@@ -1,6 +1,8 @@
 #ifndef _PAIR_H
 #define _PAIR_H
 
+#include "pool.h"
+
 typedef  void* PairDataElement;
 typedef  void* PairKeyElement;
 typedef PairDataElement(*copyDataElement)(PairDataElement);
@@ -18,6 +20,7 @@ struct pair_t
     freeDataElement freeDataFunc;
     freeKeyElement freeKeyFunc;
 
+    Pool pool;  // the pair is allocated from pool, or with malloc if it is NULL
 };
 
 typedef struct pair_t* Pair;
@@ -40,13 +43,20 @@ typedef enum{
 Pair pairCreate(copyDataElement copyDataFunc, copyKeyElement copyKeyFunc, 
                 freeDataElement freeDataFunc, freeKeyElement freeKeyFunc);
 
+// same as pairCreate, but the pair is allocated from pool. the pool must outlive the pair.
+Pair pairCreatePooled(copyDataElement copyDataFunc, copyKeyElement copyKeyFunc, 
+                      freeDataElement freeDataFunc, freeKeyElement freeKeyFunc, Pool pool);
+
 // sets the key and data elements of a given pair to the given data and key.
 PairErrors pairSet(Pair pair, PairDataElement data, PairKeyElement key);
 
+// same as pairSet, but the pair takes ownership of data and key instead of copying them.
+PairErrors pairSetTake(Pair pair, PairDataElement data, PairKeyElement key);
+
 // destroys a given pair.
 void pairFree(Pair pair);
 
-// returns a copy of a given pair.
+// returns a copy of a given pair, allocated from the same pool.
 Pair pairCopy(Pair pair);
 
 #endif
\ No newline at end of file
@@ -14,6 +14,7 @@ Player playerCreate(int id, int wins, int losses, int draws)
     player->wins = wins;
     player->losses = losses;
     player->draws = draws;
+    player->play_time = 0;
     return player;
 }
 
@@ -24,6 +25,10 @@ Player playerCopy(Player src_player)
         return NULL;
     }
     Player new_player = playerCreate(src_player->id, src_player->wins, src_player->losses, src_player->draws);
+    if(new_player != NULL)
+    {
+        new_player->play_time = src_player->play_time;
+    }
     return new_player;  // NULL if allocation failed.
 }
 
@@ -48,6 +53,26 @@ double playerGetLevel(Player player)
     int sign = level >= 0 ? 1 : -1;
     return (double)((int)((level + sign*0.004)*100))/100.0;
 }
+
+int playerCompareScore(Player player1, Player player2)
+{
+    unsigned int player1_score = 2*player1->wins + player1->draws;
+    unsigned int player2_score = 2*player2->wins + player2->draws;
+    if(player1_score == player2_score)
+    {
+        if(player1->losses == player2->losses)
+        {
+            if(player1->wins == player2->wins)
+            {
+                return player1->id - player2->id;  // decide by lowest id
+            }
+            return player2->wins - player1->wins;  // decide by highest amount of wins
+        }
+        return player1->losses - player2->losses;  // decide by lowest amount of losses
+    }
+    return player2_score - player1_score;  // decide by highest score
+}
+
 int playerGetID(Player player)
 {
     return player->id;
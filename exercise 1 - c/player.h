@@ -6,9 +6,10 @@ typedef struct player_t {
     int wins;
     int losses;
     int draws;
+    int play_time;  // total time of the player's games
 } *Player;
 
-// creates a new player and initiallizes his statistics to the given statistics.
+// creates a new player and initiallizes his statistics to the given statistics, with no play time.
 Player playerCreate(int id, int wins, int losses, int draws);
 
 /* returns a copy of src_player.
@@ -21,6 +22,13 @@ int getTotalGamesPlayed(Player player);
 // returns the level of a given player, rounded down to two decimal points.
 double playerGetLevel(Player player);
 
+/** playerCompareScore: compares two players' score in a tournament.
+ * @return
+ *      positive integer if player1's score is lower than player2's score.
+ *      negative integer if player1's score is higher than player2's score.
+ *      same score for two players is impossible.**/
+int playerCompareScore(Player player1, Player player2);
+
 // destroys a given player.
 void playerDestroy(Player player);
 
@@ -0,0 +1,223 @@
+#include <stdlib.h>
+#include "pool.h"
+
+#define POOL_FIRST_SLAB_CAPACITY 8
+#define POOL_MAX_SLAB_CAPACITY 1024
+
+// used for rounding element and header sizes, so every element is aligned for any type.
+typedef union pool_alignment_t {
+    long double long_double_member;
+    long long long_long_member;
+    void* pointer_member;
+} PoolAlignment;
+
+// a slab header, followed in memory by the elements of the slab.
+typedef union pool_slab_t {
+    struct {
+        union pool_slab_t* next;
+        int capacity;
+    } info;
+    PoolAlignment alignment;
+} *PoolSlab;
+
+// a freed element holds the next free element.
+typedef struct pool_free_element_t {
+    struct pool_free_element_t* next;
+} *PoolFreeElement;
+
+struct pool_t {
+    size_t element_size;
+    PoolSlab slabs;  // the newest slab first
+    int next_slab_capacity;
+    int unused_in_newest_slab;  // elements at the end of the newest slab which were never handed out
+    PoolFreeElement free_elements;
+    int free_elements_count;
+    int owners;
+    PoolStatistics statistics;
+};
+
+// HELPER FUNCTIONS START
+
+static char* poolSlabElements(PoolSlab slab)
+{
+    return (char*)(slab + 1);
+}
+
+// adds a slab of at least min_capacity elements.
+static PoolSlab poolAddSlab(Pool pool, int min_capacity)
+{
+    int capacity = pool->next_slab_capacity > min_capacity ? pool->next_slab_capacity : min_capacity;
+    PoolSlab slab = malloc(sizeof(*slab) + pool->element_size * capacity);
+    if(slab == NULL)
+    {
+        return NULL;
+    }
+    slab->info.next = pool->slabs;
+    slab->info.capacity = capacity;
+    pool->slabs = slab;
+    pool->unused_in_newest_slab = capacity;
+    if(pool->next_slab_capacity < POOL_MAX_SLAB_CAPACITY)
+    {
+        pool->next_slab_capacity *= 2;
+    }
+    pool->statistics.slabs++;
+    pool->statistics.elements_reserved += capacity;
+    return slab;
+}
+
+// HELPER FUNCTIONS END
+
+Pool poolCreate(size_t element_size)
+{
+    Pool pool = malloc(sizeof(*pool));
+    if(pool == NULL)
+    {
+        return NULL;
+    }
+    if(element_size < sizeof(struct pool_free_element_t))
+    {
+        element_size = sizeof(struct pool_free_element_t);
+    }
+    size_t alignment = sizeof(PoolAlignment);
+    pool->element_size = (element_size + alignment - 1) / alignment * alignment;
+    pool->slabs = NULL;
+    pool->next_slab_capacity = POOL_FIRST_SLAB_CAPACITY;
+    pool->unused_in_newest_slab = 0;
+    pool->free_elements = NULL;
+    pool->free_elements_count = 0;
+    pool->owners = 1;
+    pool->statistics.elements_in_use = 0;
+    pool->statistics.peak_elements_in_use = 0;
+    pool->statistics.elements_reserved = 0;
+    pool->statistics.slabs = 0;
+    pool->statistics.allocations = 0;
+    return pool;
+}
+
+void poolDestroy(Pool pool)
+{
+    if(pool == NULL)
+    {
+        return;
+    }
+    pool->owners--;
+    if(pool->owners > 0)
+    {
+        return;
+    }
+    poolClear(pool);
+    free(pool);
+}
+
+Pool poolShare(Pool pool)
+{
+    if(pool != NULL)
+    {
+        pool->owners++;
+    }
+    return pool;
+}
+
+bool poolIsShared(Pool pool)
+{
+    return pool != NULL && pool->owners > 1;
+}
+
+bool poolReserve(Pool pool, int count)
+{
+    if(pool == NULL)
+    {
+        return false;
+    }
+    int available = pool->free_elements_count + pool->unused_in_newest_slab;
+    if(available >= count)
+    {
+        return true;
+    }
+    // the unused elements of the newest slab are moved to the free list, since a new slab becomes the newest.
+    while(pool->unused_in_newest_slab > 0)
+    {
+        int index = pool->slabs->info.capacity - pool->unused_in_newest_slab;
+        PoolFreeElement free_element = (PoolFreeElement)(poolSlabElements(pool->slabs) + pool->element_size * index);
+        free_element->next = pool->free_elements;
+        pool->free_elements = free_element;
+        pool->free_elements_count++;
+        pool->unused_in_newest_slab--;
+    }
+    return poolAddSlab(pool, count - available) != NULL;
+}
+
+void* poolAlloc(Pool pool)
+{
+    if(pool == NULL)
+    {
+        return NULL;
+    }
+    void* element = NULL;
+    if(pool->free_elements != NULL)
+    {
+        element = pool->free_elements;
+        pool->free_elements = pool->free_elements->next;
+        pool->free_elements_count--;
+    }
+    else
+    {
+        if(pool->unused_in_newest_slab == 0 && poolAddSlab(pool, 0) == NULL)
+        {
+            return NULL;
+        }
+        int index = pool->slabs->info.capacity - pool->unused_in_newest_slab;
+        element = poolSlabElements(pool->slabs) + pool->element_size * index;
+        pool->unused_in_newest_slab--;
+    }
+    pool->statistics.allocations++;
+    pool->statistics.elements_in_use++;
+    if(pool->statistics.elements_in_use > pool->statistics.peak_elements_in_use)
+    {
+        pool->statistics.peak_elements_in_use = pool->statistics.elements_in_use;
+    }
+    return element;
+}
+
+void poolFree(Pool pool, void* element)
+{
+    if(pool == NULL || element == NULL)
+    {
+        return;
+    }
+    PoolFreeElement free_element = element;
+    free_element->next = pool->free_elements;
+    pool->free_elements = free_element;
+    pool->free_elements_count++;
+    pool->statistics.elements_in_use--;
+}
+
+void poolClear(Pool pool)
+{
+    if(pool == NULL)
+    {
+        return;
+    }
+    while(pool->slabs)
+    {
+        PoolSlab temp = pool->slabs;
+        pool->slabs = pool->slabs->info.next;
+        free(temp);
+    }
+    pool->unused_in_newest_slab = 0;
+    pool->free_elements = NULL;
+    pool->free_elements_count = 0;
+    pool->statistics.elements_in_use = 0;
+    pool->statistics.elements_reserved = 0;
+    pool->statistics.slabs = 0;
+}
+
+PoolStatistics poolGetStatistics(Pool pool)
+{
+    if(pool == NULL)
+    {
+        PoolStatistics empty = {0, 0, 0, 0, 0};
+        return empty;
+    }
+    return pool->statistics;
+}
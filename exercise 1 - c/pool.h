@@ -0,0 +1,53 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Slab allocator for elements of a single fixed size.
+ * Elements are cut from slabs (big blocks allocated with malloc) and freed elements are kept for
+ * reuse, so allocating and freeing an element usually costs no call to malloc or free.
+ * All the slabs are freed at once when the pool is cleared or destroyed.
+*/
+
+typedef struct pool_t *Pool;
+
+typedef struct pool_statistics_t {
+    int elements_in_use;
+    int peak_elements_in_use;
+    int elements_reserved;  // elements which fit in the slabs allocated so far
+    int slabs;
+    long allocations;  // calls to poolAlloc since the pool was created
+} PoolStatistics;
+
+// creates a new empty pool of elements of element_size bytes. returns NULL on memory allocation error.
+Pool poolCreate(size_t element_size);
+
+// frees all the slabs of the pool, then frees the pool. elements which were not freed become invalid.
+// if the pool is shared, only removes one of its owners, and the pool is freed by the last one.
+void poolDestroy(Pool pool);
+
+// adds an owner to pool, so several structures which share elements can allocate from it. returns pool.
+Pool poolShare(Pool pool);
+
+// returns true if the pool has more than one owner.
+bool poolIsShared(Pool pool);
+
+// makes sure the next count calls to poolAlloc succeed without allocating memory.
+// returns false on memory allocation error.
+bool poolReserve(Pool pool, int count);
+
+// returns an uninitialized element, or NULL if pool is NULL or on memory allocation error.
+void* poolAlloc(Pool pool);
+
+// returns element to the pool for reuse. element must have been allocated from pool.
+void poolFree(Pool pool, void* element);
+
+// frees all the slabs of the pool at once. all of its elements become invalid.
+void poolClear(Pool pool);
+
+// returns the allocation statistics of the pool. all zeros if pool is NULL.
+PoolStatistics poolGetStatistics(Pool pool);
+
+#endif
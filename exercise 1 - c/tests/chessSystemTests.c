@@ -0,0 +1,581 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../chessSystem.h"
+#include "test_utilities.h"
+
+#define STATISTICS_FILE "chess_test_statistics.txt"
+#define LEVELS_FILE "chess_test_levels.txt"
+#define MAX_TOP_PLAYERS 20
+#define SNAPSHOT_FILE "chess_test_snapshot.bin"
+#define JOURNAL_FILE "chess_test_journal.bin"
+#define FIRST_DESCRIPTION_FILE "chess_test_first.txt"
+#define SECOND_DESCRIPTION_FILE "chess_test_second.txt"
+#define MAX_PLAYER_ID 12
+#define MAX_TOURNAMENT_ID 5
+
+// HELPER FUNCTIONS START
+
+// returns the contents of the file at path as a string, which the caller frees, or NULL if it could not be read.
+static char* readWholeFile(const char* path, long* size)
+{
+    FILE* file = fopen(path, "rb");
+    if(file == NULL)
+    {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* data = malloc(*size + 1);
+    if(data != NULL && fread(data, 1, *size, file) != (size_t)*size)
+    {
+        free(data);
+        data = NULL;
+    }
+    if(data != NULL)
+    {
+        data[*size] = '\0';
+    }
+    fclose(file);
+    return data;
+}
+
+// checks that the statistics chess saves are exactly expected.
+static bool statisticsAre(ChessSystem chess, const char* expected)
+{
+    remove(STATISTICS_FILE);
+    if(chessSaveTournamentStatistics(chess, STATISTICS_FILE) != CHESS_SUCCESS)
+    {
+        return false;
+    }
+    long size = 0;
+    char* statistics = readWholeFile(STATISTICS_FILE, &size);
+    remove(STATISTICS_FILE);
+    bool equal = statistics != NULL && strcmp(statistics, expected) == 0;
+    free(statistics);
+    return equal;
+}
+
+// checks that the levels chess saves are exactly expected.
+static bool levelsAre(ChessSystem chess, const char* expected)
+{
+    FILE* file = fopen(LEVELS_FILE, "w");
+    if(file == NULL)
+    {
+        return false;
+    }
+    ChessResult result = chessSavePlayersLevels(chess, file);
+    fclose(file);
+    long size = 0;
+    char* levels = readWholeFile(LEVELS_FILE, &size);
+    remove(LEVELS_FILE);
+    bool equal = result == CHESS_SUCCESS && levels != NULL && strcmp(levels, expected) == 0;
+    free(levels);
+    return equal;
+}
+
+// checks that the first k players chessGetTopPlayers returns are the first k players chessSavePlayersLevels prints,
+// with the same levels.
+static bool topPlayersMatchLevels(ChessSystem chess, int k)
+{
+    FILE* file = fopen(LEVELS_FILE, "w+");
+    if(file == NULL || chessSavePlayersLevels(chess, file) != CHESS_SUCCESS)
+    {
+        if(file != NULL)
+        {
+            fclose(file);
+        }
+        remove(LEVELS_FILE);
+        return false;
+    }
+    rewind(file);
+    int player_ids[MAX_TOP_PLAYERS];
+    double levels[MAX_TOP_PLAYERS];
+    int count = -1;
+    bool equal = chessGetTopPlayers(chess, k, player_ids, levels, &count) == CHESS_SUCCESS && count <= k;
+    int printed_count = 0, printed_id = 0;
+    double printed_level = 0;
+    while(equal && fscanf(file, "%d %lf", &printed_id, &printed_level) == 2 && printed_count < k)
+    {
+        equal = printed_count < count && player_ids[printed_count] == printed_id &&
+                levels[printed_count] > printed_level - 0.005 && levels[printed_count] < printed_level + 0.005;
+        printed_count++;
+    }
+    fclose(file);
+    remove(LEVELS_FILE);
+    return equal && printed_count == count;
+}
+
+static bool writeWholeFile(const char* path, const char* data, long size)
+{
+    FILE* file = fopen(path, "wb");
+    if(file == NULL)
+    {
+        return false;
+    }
+    bool written = fwrite(data, 1, size, file) == (size_t)size;
+    return fclose(file) == 0 && written;
+}
+
+// writes everything chess reports about its players and tournaments to path.
+static bool describeSystem(ChessSystem chess, const char* path)
+{
+    remove(STATISTICS_FILE);
+    ChessResult statistics_result = chessSaveTournamentStatistics(chess, STATISTICS_FILE);
+    long size = 0;
+    char* statistics = statistics_result == CHESS_SUCCESS ? readWholeFile(STATISTICS_FILE, &size) : NULL;
+    remove(STATISTICS_FILE);
+    FILE* file = fopen(path, "w");
+    if(file == NULL)
+    {
+        free(statistics);
+        return false;
+    }
+    chessSavePlayersLevels(chess, file);
+    for(int player_id = 1; player_id <= MAX_PLAYER_ID; player_id++)
+    {
+        ChessResult result;
+        double average = chessCalculateAveragePlayTime(chess, player_id, &result);
+        fprintf(file, "%d %d %.4f\n", player_id, result, average);
+    }
+    for(int tournament_id = 1; tournament_id <= MAX_TOURNAMENT_ID; tournament_id++)
+    {
+        int leader_id = 0;
+        ChessResult result = chessGetTournamentLeader(chess, tournament_id, &leader_id);
+        fprintf(file, "%d %d %d\n", tournament_id, result, leader_id);
+    }
+    fprintf(file, "%d\n%s", statistics_result, statistics == NULL ? "" : statistics);
+    free(statistics);
+    return fclose(file) == 0;
+}
+
+static bool systemsAreEqual(ChessSystem first, ChessSystem second)
+{
+    long first_size = 0, second_size = 0;
+    char* first_description = NULL;
+    char* second_description = NULL;
+    if(describeSystem(first, FIRST_DESCRIPTION_FILE) && describeSystem(second, SECOND_DESCRIPTION_FILE))
+    {
+        first_description = readWholeFile(FIRST_DESCRIPTION_FILE, &first_size);
+        second_description = readWholeFile(SECOND_DESCRIPTION_FILE, &second_size);
+    }
+    remove(FIRST_DESCRIPTION_FILE);
+    remove(SECOND_DESCRIPTION_FILE);
+    bool equal = first_description != NULL && second_description != NULL &&
+                 strcmp(first_description, second_description) == 0;
+    free(first_description);
+    free(second_description);
+    return equal;
+}
+
+// adds tournaments, games, a removed player and an ended tournament to chess.
+static void fillSystem(ChessSystem chess)
+{
+    chessAddTournament(chess, 1, 4, "Haifa");
+    chessAddTournament(chess, 2, 3, "Tel aviv");
+    chessAddTournament(chess, 3, 2, "Eilat");
+    chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 6);
+    chessAddGame(chess, 1, 1, 3, DRAW, 10);
+    chessAddGame(chess, 1, 2, 3, SECOND_PLAYER, 4);
+    chessAddGame(chess, 1, 4, 1, SECOND_PLAYER, 8);
+    chessAddGame(chess, 2, 5, 6, DRAW, 12);
+    chessAddGame(chess, 2, 6, 7, FIRST_PLAYER, 3);
+    chessAddGame(chess, 2, 3, 5, SECOND_PLAYER, 9);
+    chessAddGame(chess, 3, 8, 9, FIRST_PLAYER, 20);
+    chessEndTournament(chess, 2);
+    chessRemovePlayer(chess, 3);
+}
+
+static void cleanJournalFiles()
+{
+    remove(SNAPSHOT_FILE);
+    remove(SNAPSHOT_FILE ".tmp");
+    remove(JOURNAL_FILE);
+}
+
+// HELPER FUNCTIONS END
+
+bool testChessAddGameAndStatistics()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chess != NULL);
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, STATISTICS_FILE) == CHESS_NO_TOURNAMENTS_ENDED);
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "Haifa") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 2, "haifa") == CHESS_INVALID_LOCATION);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 1, DRAW, 5) == CHESS_GAME_ALREADY_EXISTS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 3, SECOND_PLAYER, 7) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 4, DRAW, 1) == CHESS_EXCEEDED_GAMES);
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, STATISTICS_FILE) == CHESS_NO_TOURNAMENTS_ENDED);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_TOURNAMENT_ENDED);
+    // a save replaces whatever the file held before, and leaves no temporary file behind.
+    FILE* file = fopen(STATISTICS_FILE, "w");
+    ASSERT_TEST(file != NULL);
+    fprintf(file, "an older and much longer file than the statistics\n");
+    fclose(file);
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, STATISTICS_FILE) == CHESS_SUCCESS);
+    long size = 0;
+    char* statistics = readWholeFile(STATISTICS_FILE, &size);
+    remove(STATISTICS_FILE);
+    bool expected = statistics != NULL && strcmp(statistics, "3\n7\n6.00\nHaifa\n2\n3\n") == 0;
+    free(statistics);
+    ASSERT_TEST(expected);
+    ASSERT_TEST(fopen(STATISTICS_FILE ".tmp", "r") == NULL);
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, "no_such_directory/" STATISTICS_FILE) == CHESS_SAVE_FAILURE);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessStatisticsOfEndedTournaments()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 2, 3, "Acre") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 1, 3, "Haifa") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 2, FIRST_PLAYER, 4) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 1, 3, DRAW, 9) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 2, 3, SECOND_PLAYER, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 4, 5, DRAW, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(statisticsAre(chess, "1\n9\n5.00\nAcre\n3\n3\n"));
+    // the statistics of an ended tournament stay as they were when players are removed.
+    ASSERT_TEST(chessRemovePlayer(chess, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 4, 6, FIRST_PLAYER, 11) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(statisticsAre(chess, "4\n11\n7.00\nHaifa\n2\n3\n1\n9\n5.00\nAcre\n3\n3\n"));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemoveTournament(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessSaveTournamentStatistics(chess, STATISTICS_FILE) == CHESS_NO_TOURNAMENTS_ENDED);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessTournamentsInIdOrder()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chess != NULL);
+    ASSERT_TEST(chessAddTournament(chess, 3, 2, "Eilat") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "Haifa") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 2, "Acre") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 1, 2, "Haifa") == CHESS_TOURNAMENT_ALREADY_EXISTS);
+    ASSERT_TEST(chessAddGame(chess, 3, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 3, 4, SECOND_PLAYER, 7) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 5, 6, FIRST_PLAYER, 9) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    // the ended tournaments are written in the order of their ids, whatever order they were added in.
+    ASSERT_TEST(statisticsAre(chess, "4\n7\n7.00\nHaifa\n1\n2\n1\n5\n5.00\nEilat\n1\n2\n"));
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemoveTournament(chess, 1) == CHESS_TOURNAMENT_NOT_EXIST);
+    ASSERT_TEST(statisticsAre(chess, "1\n5\n5.00\nEilat\n1\n2\n"));
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessRemovePlayerGivesWins()
+{
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessAddTournament(chess, 1, 3, "Haifa") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 3, "Eilat") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 3, 1, DRAW, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, SECOND_PLAYER, 10) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 4, 1, FIRST_PLAYER, 6) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_PLAYER_NOT_EXIST);
+    // the opponents of the removed player win the games of the live tournament, and the ended one keeps its results.
+    ASSERT_TEST(levelsAre(chess, "3 6.00\n4 6.00\n2 -2.00\n"));
+    // the second player of a game whose first player was removed is removed from it as well.
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(levelsAre(chess, "3 6.00\n4 6.00\n"));
+    ASSERT_TEST(chessEndTournament(chess, 1) == CHESS_SUCCESS);
+    // the statistics count every player who played in a tournament, removed or not.
+    ASSERT_TEST(statisticsAre(chess, "3\n10\n6.67\nHaifa\n3\n3\n4\n6\n6.00\nEilat\n1\n2\n"));
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessTopPlayers()
+{
+    ChessSystem chess = chessCreate();
+    int player_ids[MAX_TOP_PLAYERS];
+    int count = -1;
+    ASSERT_TEST(chessGetTopPlayers(chess, 3, player_ids, NULL, &count) == CHESS_SUCCESS && count == 0);
+    ASSERT_TEST(chessAddTournament(chess, 1, 5, "Haifa") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddTournament(chess, 2, 5, "Acre") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 3, 4, DRAW, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 3, SECOND_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 5, 1, SECOND_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 6, 4, DRAW, 5) == CHESS_SUCCESS);
+    for(int k = 0; k <= 6; k++)
+    {
+        ASSERT_TEST(topPlayersMatchLevels(chess, k));
+    }
+    // asking for more players than there are returns all of them.
+    ASSERT_TEST(chessGetTopPlayers(chess, MAX_TOP_PLAYERS, player_ids, NULL, &count) == CHESS_SUCCESS && count == 6);
+    ASSERT_TEST(topPlayersMatchLevels(chess, MAX_TOP_PLAYERS));
+    // the order follows the changes of the levels.
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(topPlayersMatchLevels(chess, MAX_TOP_PLAYERS));
+    ASSERT_TEST(chessRemoveTournament(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(topPlayersMatchLevels(chess, 2) && topPlayersMatchLevels(chess, MAX_TOP_PLAYERS));
+    ASSERT_TEST(chessGetTopPlayers(chess, 1, NULL, NULL, &count) == CHESS_NULL_ARGUMENT);
+    ASSERT_TEST(chessGetTopPlayers(chess, 1, player_ids, NULL, NULL) == CHESS_NULL_ARGUMENT);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessTournamentLeader()
+{
+    ChessSystem chess = chessCreate();
+    int leader_id = 0;
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &leader_id) == CHESS_TOURNAMENT_NOT_EXIST);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 0, &leader_id) == CHESS_INVALID_ID);
+    ASSERT_TEST(chessAddTournament(chess, 1, 3, "Haifa") == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &leader_id) == CHESS_NO_GAMES);
+    ASSERT_TEST(chessAddGame(chess, 1, 1, 2, FIRST_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 1, 3, 1, DRAW, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &leader_id) == CHESS_SUCCESS && leader_id == 1);
+    // the games of a removed player are won by the opponents, so the leader of a live tournament changes.
+    ASSERT_TEST(chessRemovePlayer(chess, 1) == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &leader_id) == CHESS_SUCCESS && leader_id == 2);
+    ASSERT_TEST(chessRemovePlayer(chess, 3) == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &leader_id) == CHESS_SUCCESS && leader_id == 2);
+    ASSERT_TEST(chessRemovePlayer(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 1, &leader_id) == CHESS_NO_GAMES);
+    // an ended tournament keeps its winner.
+    ASSERT_TEST(chessAddTournament(chess, 2, 3, "Acre") == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(chess, 2, 4, 5, SECOND_PLAYER, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessEndTournament(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemovePlayer(chess, 5) == CHESS_SUCCESS);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 2, &leader_id) == CHESS_SUCCESS && leader_id == 5);
+    ASSERT_TEST(chessGetTournamentLeader(chess, 2, NULL) == CHESS_NULL_ARGUMENT);
+    chessDestroy(chess);
+    return true;
+}
+
+bool testChessSnapshotRoundTrip()
+{
+    remove(SNAPSHOT_FILE);
+    ChessSystem chess = chessCreate();
+    fillSystem(chess);
+    ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS);
+    ChessResult result;
+    ChessSystem loaded = chessLoadSnapshot(SNAPSHOT_FILE, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS && loaded != NULL);
+    ASSERT_TEST(systemsAreEqual(chess, loaded));
+    // the restored system keeps working like the saved one.
+    ASSERT_TEST(chessAddGame(chess, 1, 2, 4, DRAW, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(loaded, 1, 2, 4, DRAW, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGame(loaded, 2, 6, 8, DRAW, 2) == CHESS_TOURNAMENT_ENDED);
+    ASSERT_TEST(chessRemoveTournament(chess, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(chessRemoveTournament(loaded, 2) == CHESS_SUCCESS);
+    ASSERT_TEST(systemsAreEqual(chess, loaded));
+    chessDestroy(loaded);
+    chessDestroy(chess);
+    remove(SNAPSHOT_FILE);
+    return true;
+}
+
+bool testChessCorruptedSnapshot()
+{
+    remove(SNAPSHOT_FILE);
+    ChessResult result;
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_FILE, &result) == NULL && result == CHESS_LOAD_FAILURE);
+    ChessSystem chess = chessCreate();
+    fillSystem(chess);
+    ASSERT_TEST(chessSaveSnapshot(chess, SNAPSHOT_FILE) == CHESS_SUCCESS);
+    chessDestroy(chess);
+    long size = 0;
+    char* snapshot = readWholeFile(SNAPSHOT_FILE, &size);
+    ASSERT_TEST(snapshot != NULL);
+
+    snapshot[size / 2] ^= 0x40;  // a flipped bit fails the checksum
+    ASSERT_TEST(writeWholeFile(SNAPSHOT_FILE, snapshot, size));
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_FILE, &result) == NULL && result == CHESS_LOAD_FAILURE);
+    snapshot[size / 2] ^= 0x40;
+
+    ASSERT_TEST(writeWholeFile(SNAPSHOT_FILE, snapshot, size - 3));  // a truncated snapshot
+    ASSERT_TEST(chessLoadSnapshot(SNAPSHOT_FILE, &result) == NULL && result == CHESS_LOAD_FAILURE);
+
+    ASSERT_TEST(writeWholeFile(SNAPSHOT_FILE, snapshot, size));  // the intact snapshot still loads
+    chess = chessLoadSnapshot(SNAPSHOT_FILE, &result);
+    ASSERT_TEST(chess != NULL && result == CHESS_SUCCESS);
+    chessDestroy(chess);
+    free(snapshot);
+    remove(SNAPSHOT_FILE);
+    return true;
+}
+
+bool testChessJournalRecover()
+{
+    cleanJournalFiles();
+    ChessSystem chess = chessCreate();
+    chessAddTournament(chess, 4, 3, "Acre");
+    chessAddGame(chess, 4, 10, 11, DRAW, 3);
+    ASSERT_TEST(chessOpenJournal(chess, SNAPSHOT_FILE, JOURNAL_FILE) == CHESS_SUCCESS);
+    fillSystem(chess);
+    ASSERT_TEST(chessCheckpoint(chess) == CHESS_SUCCESS);
+    chessAddGame(chess, 1, 2, 4, FIRST_PLAYER, 7);
+    chessRemoveTournament(chess, 3);
+    chessEndTournament(chess, 1);
+    ASSERT_TEST(chessSyncJournal(chess) == CHESS_SUCCESS);
+
+    ChessResult result;
+    ChessSystem recovered = chessRecover(SNAPSHOT_FILE, JOURNAL_FILE, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS && recovered != NULL);
+    ASSERT_TEST(systemsAreEqual(chess, recovered));
+    chessDestroy(recovered);
+    ASSERT_TEST(chessCloseJournal(chess) == CHESS_SUCCESS);
+    chessDestroy(chess);
+    cleanJournalFiles();
+    return true;
+}
+
+bool testChessTornJournal()
+{
+    cleanJournalFiles();
+    ChessSystem chess = chessCreate();
+    ASSERT_TEST(chessOpenJournal(chess, SNAPSHOT_FILE, JOURNAL_FILE) == CHESS_SUCCESS);
+    fillSystem(chess);
+    ASSERT_TEST(chessSyncJournal(chess) == CHESS_SUCCESS);
+    long complete_size = 0;
+    free(readWholeFile(JOURNAL_FILE, &complete_size));
+
+    // the system as it was when the journal was synced, before the last change.
+    ChessResult result;
+    ChessSystem expected = chessRecover(SNAPSHOT_FILE, JOURNAL_FILE, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS && expected != NULL);
+    ASSERT_TEST(chessAddGame(chess, 1, 5, 7, DRAW, 4) == CHESS_SUCCESS);
+    ASSERT_TEST(chessCloseJournal(chess) == CHESS_SUCCESS);
+    long size = 0;
+    char* journal = readWholeFile(JOURNAL_FILE, &size);
+    ASSERT_TEST(journal != NULL && size > complete_size);
+
+    // the last record was cut in the middle, so it is dropped and the records before it are replayed.
+    ASSERT_TEST(writeWholeFile(JOURNAL_FILE, journal, size - 5));
+    ChessSystem recovered = chessRecover(SNAPSHOT_FILE, JOURNAL_FILE, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS && recovered != NULL);
+    ASSERT_TEST(systemsAreEqual(expected, recovered));
+    chessDestroy(recovered);
+
+    // a last record whose checksum is wrong is dropped the same way.
+    journal[size - 1] ^= 0x01;
+    ASSERT_TEST(writeWholeFile(JOURNAL_FILE, journal, size));
+    recovered = chessRecover(SNAPSHOT_FILE, JOURNAL_FILE, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS && recovered != NULL);
+    ASSERT_TEST(systemsAreEqual(expected, recovered));
+    chessDestroy(recovered);
+
+    // the intact journal gives the system with the last change.
+    journal[size - 1] ^= 0x01;
+    ASSERT_TEST(writeWholeFile(JOURNAL_FILE, journal, size));
+    recovered = chessRecover(SNAPSHOT_FILE, JOURNAL_FILE, &result);
+    ASSERT_TEST(result == CHESS_SUCCESS && recovered != NULL);
+    ASSERT_TEST(systemsAreEqual(chess, recovered));
+    chessDestroy(recovered);
+
+    free(journal);
+    chessDestroy(expected);
+    chessDestroy(chess);
+    cleanJournalFiles();
+    return true;
+}
+
+
+bool testChessAddGamesBatch()
+{
+    ChessSystem batch_chess = chessCreate();
+    ChessSystem single_chess = chessCreate();
+    fillSystem(batch_chess);
+    fillSystem(single_chess);
+    GameRecord records[] = {
+        {1, 2, 4, DRAW, 5},         // a new game
+        {2, 6, 8, DRAW, 5},         // tournament 2 ended
+        {3, 8, 10, SECOND_PLAYER, 2},
+        {1, 1, 2, DRAW, 5},         // already played
+        {7, 1, 2, DRAW, 5},         // no such tournament
+        {1, 5, 5, DRAW, 5},         // the same player twice
+        {3, 8, 11, FIRST_PLAYER, 2},  // player 8 reaches the max games of tournament 3
+        {3, 8, 12, FIRST_PLAYER, 2},
+        {1, 5, 6, DRAW, -1},        // invalid play time
+    };
+    size_t count = sizeof(records) / sizeof(*records);
+    ChessResult results[sizeof(records) / sizeof(*records)];
+    ASSERT_TEST(chessAddGames(batch_chess, records, count, results) == CHESS_SUCCESS);
+    for(size_t i = 0; i < count; i++)
+    {
+        ChessResult single_result = chessAddGame(single_chess, records[i].tournament_id, records[i].first_player,
+                                                 records[i].second_player, records[i].winner, records[i].play_time);
+        ASSERT_TEST(results[i] == single_result);
+    }
+    ASSERT_TEST(results[0] == CHESS_SUCCESS && results[1] == CHESS_TOURNAMENT_ENDED);
+    ASSERT_TEST(results[7] == CHESS_EXCEEDED_GAMES);
+    ASSERT_TEST(systemsAreEqual(batch_chess, single_chess));
+    ASSERT_TEST(chessAddGames(batch_chess, NULL, 0, NULL) == CHESS_SUCCESS);
+    ASSERT_TEST(chessAddGames(batch_chess, NULL, 1, results) == CHESS_NULL_ARGUMENT);
+    chessDestroy(batch_chess);
+    chessDestroy(single_chess);
+    return true;
+}
+
+
+/*The functions for the tests should be added here*/
+bool (*tests[]) (void) = {
+        testChessAddGameAndStatistics,
+        testChessStatisticsOfEndedTournaments,
+        testChessTournamentsInIdOrder,
+        testChessRemovePlayerGivesWins,
+        testChessTopPlayers,
+        testChessTournamentLeader,
+        testChessSnapshotRoundTrip,
+        testChessCorruptedSnapshot,
+        testChessJournalRecover,
+        testChessTornJournal,
+        testChessAddGamesBatch
+};
+
+/*The names of the test functions should be added here*/
+const char* testNames[] = {
+        "testChessAddGameAndStatistics",
+        "testChessStatisticsOfEndedTournaments",
+        "testChessTournamentsInIdOrder",
+        "testChessRemovePlayerGivesWins",
+        "testChessTopPlayers",
+        "testChessTournamentLeader",
+        "testChessSnapshotRoundTrip",
+        "testChessCorruptedSnapshot",
+        "testChessJournalRecover",
+        "testChessTornJournal",
+        "testChessAddGamesBatch"
+};
+
+#define NUMBER_TESTS ((long)(sizeof(tests)/sizeof(*tests)))
+
+int main(int argc, char *argv[]) {
+    int failed_tests = 0;
+    if (argc == 1) {
+        for (int test_idx = 0; test_idx < NUMBER_TESTS; test_idx++) {
+            RUN_TEST(tests[test_idx], testNames[test_idx]);
+        }
+        return failed_tests == 0 ? 0 : 1;
+    }
+    if (argc != 2) {
+        fprintf(stdout, "Usage: chess <test index>\n");
+        return 0;
+    }
+
+    int test_idx = strtol(argv[1], NULL, 10);
+    if (test_idx < 1 || test_idx > NUMBER_TESTS) {
+        fprintf(stderr, "Invalid test index %d\n", test_idx);
+        return 0;
+    }
+
+    RUN_TEST(tests[test_idx - 1], testNames[test_idx - 1]);
+    return failed_tests == 0 ? 0 : 1;
+}
@@ -0,0 +1,1007 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../map.h"
+#include "test_utilities.h"
+
+#define KEY_RANGE 200
+#define OPERATIONS 2000
+
+// HELPER FUNCTIONS START
+
+static MapKeyElement copyInt(MapKeyElement element)
+{
+    if(element == NULL)  // the list backend copies the key of its empty head
+    {
+        return NULL;
+    }
+    int* copy = malloc(sizeof(*copy));
+    if(copy != NULL)
+    {
+        *copy = *(int*)element;
+    }
+    return copy;
+}
+
+static void freeInt(MapKeyElement element)
+{
+    free(element);
+}
+
+static int compareInt(MapKeyElement element1, MapKeyElement element2)
+{
+    return *(int*)element1 - *(int*)element2;
+}
+
+static Map createIntList()
+{
+    return mapCreate(copyInt, copyInt, freeInt, freeInt, compareInt);
+}
+
+static Map createIntTree()
+{
+    return mapCreateTree(copyInt, copyInt, freeInt, freeInt, compareInt);
+}
+
+static unsigned int hashInt(MapKeyElement element)
+{
+    return (unsigned int)*(int*)element;
+}
+
+// puts most keys into a few long clusters, so probing and the shifts of removes are exercised.
+static unsigned int hashIntColliding(MapKeyElement element)
+{
+    return (unsigned int)(*(int*)element % 5);
+}
+
+static Map createIntHash()
+{
+    return mapCreateHash(copyInt, copyInt, freeInt, freeInt, compareInt, hashInt);
+}
+
+static Map createIntCollidingHash()
+{
+    return mapCreateHash(copyInt, copyInt, freeInt, freeInt, compareInt, hashIntColliding);
+}
+
+static Map createIntInline()
+{
+    return mapCreateInline(sizeof(int), sizeof(int), compareInt);
+}
+
+static Map createIntInlineHash()
+{
+    return mapCreateInlineHash(sizeof(int), sizeof(int), compareInt, hashIntColliding);
+}
+
+// returns the next number of a fixed pseudo random sequence, so every run makes the same operations.
+static int nextRandom(unsigned int* seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return (int)((*seed >> 16) % 0x8000);
+}
+
+// checks that the two maps hold the same keys and data, in the same order.
+static bool mapsHoldTheSame(Map map1, Map map2)
+{
+    if(mapGetSize(map1) != mapGetSize(map2))
+    {
+        return false;
+    }
+    int* key1 = mapGetFirst(map1);
+    int* key2 = mapGetFirst(map2);
+    bool equal = true;
+    while(key1 != NULL && key2 != NULL)
+    {
+        equal = equal && *key1 == *key2 && *(int*)mapGet(map1, key1) == *(int*)mapGet(map2, key2);
+        free(key1);
+        free(key2);
+        key1 = mapGetNext(map1);
+        key2 = mapGetNext(map2);
+    }
+    equal = equal && key1 == NULL && key2 == NULL;
+    free(key1);
+    free(key2);
+    return equal;
+}
+
+// checks that an external iterator visits the same keys in the same order as the internal iterator, and hands out
+// the key and data stored in the map instead of copies.
+static bool mapIterMatchesInternalIterator(Map map)
+{
+    MapIterator iterator = mapIterBegin(map);
+    if(mapIterFailed(&iterator))
+    {
+        return false;
+    }
+    bool equal = true;
+    int* key = mapGetFirst(map);
+    for(; key != NULL && mapIterKey(&iterator) != NULL; mapIterNext(&iterator))
+    {
+        int* stored_key = mapIterKey(&iterator);
+        equal = equal && *stored_key == *key && mapIterData(&iterator) == mapGet(map, key);
+        free(key);
+        key = mapGetNext(map);
+    }
+    equal = equal && key == NULL && mapIterKey(&iterator) == NULL && !mapIterFailed(&iterator);
+    free(key);
+    return equal;
+}
+
+// checks that map holds exactly the keys marked in present, in increasing order, each with its data in values.
+static bool mapHoldsInOrder(Map map, const bool* present, const int* values)
+{
+    int expected_size = 0;
+    int previous = -1;
+    MAP_FOREACH(int*, key, map)
+    {
+        bool valid = *key > previous && *key < KEY_RANGE && present[*key];
+        int* data = valid ? mapGet(map, key) : NULL;
+        valid = data != NULL && *data == values[*key];
+        previous = *key;
+        free(key);
+        if(!valid)
+        {
+            return false;
+        }
+    }
+    for(int i = 0; i < KEY_RANGE; i++)
+    {
+        expected_size += present[i] ? 1 : 0;
+    }
+    return mapGetSize(map) == expected_size;
+}
+
+// puts and removes pseudo random keys in map, checking every result against a plain array, and then the order.
+static bool mapCheckInterleavedPutRemove(Map map, unsigned int seed)
+{
+    bool present[KEY_RANGE] = {false};
+    int values[KEY_RANGE] = {0};
+    for(int i = 0; i < OPERATIONS; i++)
+    {
+        int key = nextRandom(&seed) % KEY_RANGE;
+        if(nextRandom(&seed) % 3 == 0)
+        {
+            MapResult expected = present[key] ? MAP_SUCCESS : MAP_ITEM_DOES_NOT_EXIST;
+            if(mapRemove(map, &key) != expected)
+            {
+                return false;
+            }
+            present[key] = false;
+        }
+        else
+        {
+            values[key] = i;
+            if(mapPut(map, &key, &i) != MAP_SUCCESS)
+            {
+                return false;
+            }
+            present[key] = true;
+        }
+        if(mapContains(map, &key) != present[key])
+        {
+            return false;
+        }
+    }
+    return mapHoldsInOrder(map, present, values);
+}
+
+// checks that the range iterator of map visits exactly the keys between low and high which are marked in present,
+// in increasing order.
+static bool mapRangeVisits(Map map, int low, int high, const bool* present)
+{
+    int expected = low < 0 ? 0 : low;
+    bool valid = true;
+    MAP_RANGE_FOREACH(iterator, map, &low, &high)
+    {
+        int key = *(int*)mapIterKey(&iterator);
+        while(expected < KEY_RANGE && !present[expected])
+        {
+            expected++;
+        }
+        valid = valid && key == expected;
+        expected++;
+    }
+    while(expected <= high && expected < KEY_RANGE && !present[expected])
+    {
+        expected++;
+    }
+    return valid && (expected > high || expected >= KEY_RANGE);
+}
+
+// checks that the bound iterators of map start at the first key marked in present which is not smaller than key
+// (or greater than it, for the upper bound), and go on in order to the end of the map.
+static bool mapBoundsStartAt(Map map, int key, const bool* present)
+{
+    int lower = key < 0 ? 0 : key;
+    while(lower < KEY_RANGE && !present[lower])
+    {
+        lower++;
+    }
+    int upper = key < 0 ? 0 : key + 1;
+    while(upper < KEY_RANGE && !present[upper])
+    {
+        upper++;
+    }
+    MapIterator lower_iterator = mapLowerBound(map, &key);
+    MapIterator upper_iterator = mapUpperBound(map, &key);
+    int* lower_key = mapIterKey(&lower_iterator);
+    int* upper_key = mapIterKey(&upper_iterator);
+    if((lower >= KEY_RANGE) != (lower_key == NULL) || (upper >= KEY_RANGE) != (upper_key == NULL))
+    {
+        return false;
+    }
+    if((lower_key != NULL && *lower_key != lower) || (upper_key != NULL && *upper_key != upper))
+    {
+        return false;
+    }
+    // a bound iterator is not limited, and goes on over every greater key.
+    int count = 0;
+    for(; mapIterKey(&lower_iterator) != NULL; mapIterNext(&lower_iterator))
+    {
+        count++;
+    }
+    for(int i = lower; i < KEY_RANGE; i++)
+    {
+        count -= present[i] ? 1 : 0;
+    }
+    return count == 0;
+}
+
+// HELPER FUNCTIONS END
+
+bool testMapTreeOrderAfterPutAndRemove()
+{
+    for(unsigned int seed = 1; seed <= 5; seed++)
+    {
+        Map map = createIntTree();
+        ASSERT_TEST(map != NULL);
+        ASSERT_TEST(mapCheckInterleavedPutRemove(map, seed));
+        ASSERT_TEST(mapClear(map) == MAP_SUCCESS);
+        ASSERT_TEST(mapGetSize(map) == 0 && mapGetFirst(map) == NULL);
+        mapDestroy(map);
+    }
+    return true;
+}
+
+bool testMapTreeBalancedOnSortedInput()
+{
+    Map map = createIntTree();
+    bool present[KEY_RANGE] = {false};
+    int values[KEY_RANGE] = {0};
+    // ascending and descending runs are the inputs which need every kind of rotation.
+    for(int key = 0; key < KEY_RANGE / 2; key++)
+    {
+        ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        present[key] = true;
+        values[key] = key;
+    }
+    for(int key = KEY_RANGE - 1; key >= KEY_RANGE / 2; key--)
+    {
+        ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        present[key] = true;
+        values[key] = key;
+    }
+    for(int key = 0; key < KEY_RANGE; key += 2)
+    {
+        ASSERT_TEST(mapRemove(map, &key) == MAP_SUCCESS);
+        present[key] = false;
+    }
+    ASSERT_TEST(mapHoldsInOrder(map, present, values));
+    mapDestroy(map);
+    return true;
+}
+
+bool testMapTreeMatchesList()
+{
+    Map list = createIntList();
+    Map tree = createIntTree();
+    ASSERT_TEST(mapCheckInterleavedPutRemove(list, 7));
+    ASSERT_TEST(mapCheckInterleavedPutRemove(tree, 7));
+    ASSERT_TEST(mapsHoldTheSame(list, tree));
+    mapDestroy(list);
+    mapDestroy(tree);
+    return true;
+}
+
+bool testMapTreeCopy()
+{
+    Map map = createIntTree();
+    for(int key = 0; key < 10; key++)
+    {
+        ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+    }
+    Map copy = mapCopy(map);
+    ASSERT_TEST(copy != NULL && mapGetSize(copy) == 10);
+    int key = 3, data = 100;
+    ASSERT_TEST(mapPut(map, &key, &data) == MAP_SUCCESS);
+    ASSERT_TEST(mapRemove(map, &(int){4}) == MAP_SUCCESS);
+    ASSERT_TEST(*(int*)mapGet(copy, &key) == 3);
+    ASSERT_TEST(mapContains(copy, &(int){4}));
+    ASSERT_TEST(mapGetSize(map) == 9 && mapGetSize(copy) == 10);
+    mapDestroy(map);
+    ASSERT_TEST(*(int*)mapGet(copy, &(int){9}) == 9);
+    mapDestroy(copy);
+    return true;
+}
+
+bool testMapTreeNullArguments()
+{
+    int key = 1;
+    ASSERT_TEST(mapCreateTree(NULL, copyInt, freeInt, freeInt, compareInt) == NULL);
+    Map map = createIntTree();
+    ASSERT_TEST(mapPut(NULL, &key, &key) == MAP_NULL_ARGUMENT);
+    ASSERT_TEST(mapPut(map, NULL, &key) == MAP_NULL_ARGUMENT);
+    ASSERT_TEST(mapRemove(map, NULL) == MAP_NULL_ARGUMENT);
+    ASSERT_TEST(mapRemove(map, &key) == MAP_ITEM_DOES_NOT_EXIST);
+    ASSERT_TEST(mapGet(map, &key) == NULL);
+    ASSERT_TEST(mapGetSize(NULL) == -1);
+    ASSERT_TEST(mapCopy(NULL) == NULL);
+    mapDestroy(map);
+    return true;
+}
+
+bool testMapHashOrderAfterPutAndRemove()
+{
+    for(unsigned int seed = 1; seed <= 5; seed++)
+    {
+        Map map = createIntHash();
+        Map colliding = createIntCollidingHash();
+        ASSERT_TEST(map != NULL && colliding != NULL);
+        ASSERT_TEST(mapCheckInterleavedPutRemove(map, seed));
+        ASSERT_TEST(mapCheckInterleavedPutRemove(colliding, seed));
+        ASSERT_TEST(mapsHoldTheSame(map, colliding));
+        mapDestroy(map);
+        mapDestroy(colliding);
+    }
+    return true;
+}
+
+bool testMapHashMatchesTree()
+{
+    Map tree = createIntTree();
+    Map hash = createIntCollidingHash();
+    ASSERT_TEST(mapCheckInterleavedPutRemove(tree, 11));
+    ASSERT_TEST(mapCheckInterleavedPutRemove(hash, 11));
+    ASSERT_TEST(mapsHoldTheSame(tree, hash));
+    // the sorted index is built again after the keys change.
+    int key = KEY_RANGE + 1;
+    ASSERT_TEST(mapPut(tree, &key, &key) == MAP_SUCCESS && mapPut(hash, &key, &key) == MAP_SUCCESS);
+    ASSERT_TEST(mapsHoldTheSame(tree, hash));
+    int* first = mapGetFirst(hash);
+    ASSERT_TEST(first != NULL);
+    ASSERT_TEST(mapRemove(tree, first) == MAP_SUCCESS && mapRemove(hash, first) == MAP_SUCCESS);
+    free(first);
+    ASSERT_TEST(mapsHoldTheSame(tree, hash));
+    mapDestroy(tree);
+    mapDestroy(hash);
+    return true;
+}
+
+bool testMapHashCopy()
+{
+    Map map = createIntCollidingHash();
+    for(int key = 0; key < 50; key++)
+    {
+        ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+    }
+    Map copy = mapCopy(map);
+    ASSERT_TEST(copy != NULL && mapsHoldTheSame(map, copy));
+    for(int key = 0; key < 50; key += 2)
+    {
+        ASSERT_TEST(mapRemove(map, &key) == MAP_SUCCESS);
+    }
+    int key = 1, data = -1;
+    ASSERT_TEST(mapPut(map, &key, &data) == MAP_SUCCESS);
+    ASSERT_TEST(mapGetSize(map) == 25 && mapGetSize(copy) == 50);
+    ASSERT_TEST(*(int*)mapGet(copy, &key) == 1 && mapContains(copy, &(int){2}));
+    mapDestroy(map);
+    ASSERT_TEST(*(int*)mapGet(copy, &(int){49}) == 49);
+    mapDestroy(copy);
+    ASSERT_TEST(mapCreateHash(copyInt, copyInt, freeInt, freeInt, compareInt, NULL) == NULL);
+    return true;
+}
+
+bool testMapIterOrderAfterPutAndRemove()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash, createIntCollidingHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        MapIterator empty_iterator = mapIterBegin(map);
+        ASSERT_TEST(mapIterKey(&empty_iterator) == NULL && mapIterData(&empty_iterator) == NULL);
+        ASSERT_TEST(!mapIterFailed(&empty_iterator));
+        ASSERT_TEST(mapCheckInterleavedPutRemove(map, 3));
+        ASSERT_TEST(mapIterMatchesInternalIterator(map));
+        // the index of a hash map is built again by the next iteration after a change.
+        int key = KEY_RANGE + 5;
+        ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        ASSERT_TEST(mapIterMatchesInternalIterator(map));
+        mapDestroy(map);
+    }
+    MapIterator null_iterator = mapIterBegin(NULL);
+    ASSERT_TEST(mapIterKey(&null_iterator) == NULL && !mapIterFailed(&null_iterator));
+    ASSERT_TEST(mapIterKey(NULL) == NULL && !mapIterFailed(NULL));
+    mapIterNext(NULL);
+    return true;
+}
+
+bool testMapIterNested()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        for(int key = 0; key < 20; key++)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        }
+        // every pair of keys is visited once by two iterators which run over the map at the same time.
+        int pairs = 0;
+        MAP_ITER_FOREACH(outer, map)
+        {
+            int outer_key = *(int*)mapIterKey(&outer);
+            MAP_ITER_FOREACH(inner, map)
+            {
+                ASSERT_TEST(*(int*)mapIterData(&inner) == *(int*)mapIterKey(&inner));
+                pairs += outer_key < *(int*)mapIterKey(&inner) ? 1 : 0;
+            }
+            ASSERT_TEST(*(int*)mapIterKey(&outer) == outer_key);
+        }
+        ASSERT_TEST(pairs == 20 * 19 / 2);
+        // data handed out by the iterator is the data stored in the map.
+        MAP_ITER_FOREACH(iterator, map)
+        {
+            *(int*)mapIterData(&iterator) += 100;
+        }
+        ASSERT_TEST(*(int*)mapGet(map, &(int){7}) == 107);
+        mapDestroy(map);
+    }
+    return true;
+}
+
+bool testMapSizeAndIsEmpty()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        ASSERT_TEST(mapGetSize(map) == 0 && mapIsEmpty(map));
+        for(int key = 0; key < 30; key++)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+            ASSERT_TEST(mapGetSize(map) == key + 1 && !mapIsEmpty(map));
+        }
+        ASSERT_TEST(mapPut(map, &(int){5}, &(int){6}) == MAP_SUCCESS && mapGetSize(map) == 30);
+        // removing the first, a middle and the last key, then the rest.
+        int order[] = {0, 15, 29};
+        for(int j = 0; j < 3; j++)
+        {
+            ASSERT_TEST(mapRemove(map, &order[j]) == MAP_SUCCESS && mapGetSize(map) == 29 - j);
+        }
+        for(int key = 1; key < 29; key++)
+        {
+            MapResult expected = key == 15 ? MAP_ITEM_DOES_NOT_EXIST : MAP_SUCCESS;
+            ASSERT_TEST(mapRemove(map, &key) == expected);
+        }
+        ASSERT_TEST(mapGetSize(map) == 0 && mapIsEmpty(map) && mapGetFirst(map) == NULL);
+        // a cleared map can be used again.
+        for(int key = 0; key < 10; key++)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        }
+        ASSERT_TEST(mapClear(map) == MAP_SUCCESS && mapGetSize(map) == 0 && mapIsEmpty(map));
+        ASSERT_TEST(!mapContains(map, &(int){3}) && mapGet(map, &(int){3}) == NULL);
+        ASSERT_TEST(mapPut(map, &(int){3}, &(int){4}) == MAP_SUCCESS && mapGetSize(map) == 1);
+        ASSERT_TEST(*(int*)mapGet(map, &(int){3}) == 4);
+        Map copy = mapCopy(map);
+        ASSERT_TEST(copy != NULL && mapGetSize(copy) == 1 && !mapIsEmpty(copy));
+        mapDestroy(copy);
+        mapDestroy(map);
+    }
+    ASSERT_TEST(mapGetSize(NULL) == -1);
+    return true;
+}
+
+bool testMapAllocationStatistics()
+{
+    Map (*create[])() = {createIntList, createIntTree};
+    int blocks_per_element[] = {2, 1};  // a list node and a pair, or a tree node
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        for(int key = 0; key < 100; key++)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        }
+        MapAllocationStatistics statistics;
+        ASSERT_TEST(mapGetAllocationStatistics(map, &statistics) == MAP_SUCCESS);
+        ASSERT_TEST(statistics.blocks_in_use == 100 * blocks_per_element[i]);
+        ASSERT_TEST(statistics.peak_blocks_in_use == statistics.blocks_in_use);
+        ASSERT_TEST(statistics.blocks_reserved >= statistics.blocks_in_use && statistics.slabs > 0);
+        // the blocks come from a few slabs, not from a malloc each.
+        ASSERT_TEST(statistics.slabs < statistics.blocks_in_use / 4);
+        for(int key = 0; key < 100; key += 2)
+        {
+            ASSERT_TEST(mapRemove(map, &key) == MAP_SUCCESS);
+        }
+        MapAllocationStatistics after_remove;
+        ASSERT_TEST(mapGetAllocationStatistics(map, &after_remove) == MAP_SUCCESS);
+        ASSERT_TEST(after_remove.blocks_in_use == 50 * blocks_per_element[i]);
+        ASSERT_TEST(after_remove.peak_blocks_in_use == statistics.peak_blocks_in_use);
+        // freed blocks are reused, so putting the keys back takes no new slab.
+        for(int key = 0; key < 100; key += 2)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        }
+        MapAllocationStatistics after_put;
+        ASSERT_TEST(mapGetAllocationStatistics(map, &after_put) == MAP_SUCCESS);
+        ASSERT_TEST(after_put.blocks_in_use == statistics.blocks_in_use);
+        ASSERT_TEST(after_put.slabs == statistics.slabs && after_put.blocks_reserved == statistics.blocks_reserved);
+        mapDestroy(map);
+    }
+    Map hash = createIntHash();
+    MapAllocationStatistics statistics;
+    ASSERT_TEST(mapPut(hash, &(int){1}, &(int){1}) == MAP_SUCCESS);
+    ASSERT_TEST(mapGetAllocationStatistics(hash, &statistics) == MAP_SUCCESS);
+    ASSERT_TEST(statistics.blocks_in_use == 0 && statistics.slabs == 0 && statistics.allocations == 0);
+    ASSERT_TEST(mapGetAllocationStatistics(NULL, &statistics) == MAP_NULL_ARGUMENT);
+    ASSERT_TEST(mapGetAllocationStatistics(hash, NULL) == MAP_NULL_ARGUMENT);
+    mapDestroy(hash);
+    return true;
+}
+
+bool testMapInlineMatchesTree()
+{
+    Map (*create[])() = {createIntInline, createIntInlineHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        for(unsigned int seed = 1; seed <= 3; seed++)
+        {
+            Map tree = createIntTree();
+            Map map = create[i]();
+            ASSERT_TEST(map != NULL);
+            ASSERT_TEST(mapCheckInterleavedPutRemove(tree, seed));
+            ASSERT_TEST(mapCheckInterleavedPutRemove(map, seed));
+            ASSERT_TEST(mapsHoldTheSame(tree, map));
+            ASSERT_TEST(mapIterMatchesInternalIterator(map));
+            Map copy = mapCopy(map);
+            ASSERT_TEST(copy != NULL && mapsHoldTheSame(map, copy));
+            // the copy has its own storage.
+            int key = KEY_RANGE + 1;
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS && !mapContains(copy, &key));
+            ASSERT_TEST(mapClear(map) == MAP_SUCCESS && mapIsEmpty(map) && mapGetSize(copy) == mapGetSize(tree));
+            mapDestroy(tree);
+            mapDestroy(map);
+            mapDestroy(copy);
+        }
+    }
+    return true;
+}
+
+bool testMapInlineStoresCopies()
+{
+    Map (*create[])() = {createIntInline, createIntInlineHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        int key = 4, data = 40;
+        ASSERT_TEST(mapPut(map, &key, &data) == MAP_SUCCESS);
+        // the map keeps the bytes of the elements, and not the pointers it was given.
+        key = 5;
+        data = 50;
+        ASSERT_TEST(*(int*)mapGet(map, &(int){4}) == 40 && !mapContains(map, &key));
+        // mapGet returns the data inside the map, and changing it changes the map.
+        *(int*)mapGet(map, &(int){4}) = 41;
+        ASSERT_TEST(*(int*)mapGet(map, &(int){4}) == 41);
+        ASSERT_TEST(mapPut(map, &(int){4}, &(int){42}) == MAP_SUCCESS && mapGetSize(map) == 1);
+        ASSERT_TEST(*(int*)mapGet(map, &(int){4}) == 42);
+        // the keys the internal iterator hands out are copies, which the caller frees.
+        int* first = mapGetFirst(map);
+        ASSERT_TEST(first != NULL && *first == 4);
+        *first = 7;
+        free(first);
+        ASSERT_TEST(mapContains(map, &(int){4}) && mapGetNext(map) == NULL);
+        mapDestroy(map);
+    }
+    // the data of a tree node stays where it is while other keys come and go.
+    Map map = createIntInline();
+    ASSERT_TEST(mapPut(map, &(int){0}, &(int){0}) == MAP_SUCCESS);
+    int* data = mapGet(map, &(int){0});
+    for(int key = 1; key < 100; key++)
+    {
+        ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+    }
+    for(int key = 1; key < 100; key += 2)
+    {
+        ASSERT_TEST(mapRemove(map, &key) == MAP_SUCCESS);
+    }
+    ASSERT_TEST(mapGet(map, &(int){0}) == data && *data == 0);
+    MapAllocationStatistics statistics;
+    ASSERT_TEST(mapGetAllocationStatistics(map, &statistics) == MAP_SUCCESS && statistics.blocks_in_use == 50);
+    mapDestroy(map);
+    return true;
+}
+
+bool testMapInlineCreate()
+{
+    ASSERT_TEST(mapCreateInline(0, sizeof(int), compareInt) == NULL);
+    ASSERT_TEST(mapCreateInline(sizeof(int), sizeof(int), NULL) == NULL);
+    ASSERT_TEST(mapCreateInlineHash(0, sizeof(int), compareInt, hashInt) == NULL);
+    ASSERT_TEST(mapCreateInlineHash(sizeof(int), sizeof(int), NULL, hashInt) == NULL);
+    ASSERT_TEST(mapCreateInlineHash(sizeof(int), sizeof(int), compareInt, NULL) == NULL);
+    // a map without data works as a set.
+    Map set = mapCreateInline(sizeof(int), 0, compareInt);
+    ASSERT_TEST(set != NULL);
+    for(int key = 9; key >= 0; key--)
+    {
+        ASSERT_TEST(mapPut(set, &key, &key) == MAP_SUCCESS);
+    }
+    int expected = 0;
+    MAP_ITER_FOREACH(iterator, set)
+    {
+        ASSERT_TEST(*(int*)mapIterKey(&iterator) == expected++);
+    }
+    ASSERT_TEST(expected == 10);
+    mapDestroy(set);
+    return true;
+}
+
+bool testMapPutTake()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        Map expected = createIntTree();
+        // descending keys put every key of the list map before its first element.
+        for(int key = 20; key >= 0; key -= 2)
+        {
+            int* taken_key = copyInt(&key);
+            int* taken_data = copyInt(&key);
+            ASSERT_TEST(mapPutTake(map, taken_key, taken_data) == MAP_SUCCESS);
+            // the map keeps the data it was given, and not a copy.
+            ASSERT_TEST(mapGet(map, &key) == taken_data);
+            ASSERT_TEST(mapPut(expected, &key, &key) == MAP_SUCCESS);
+        }
+        ASSERT_TEST(mapsHoldTheSame(map, expected));
+        // an existing key keeps its own key element, and the given key and the old data are freed.
+        int key = 10, data = 100;
+        int* taken_data = copyInt(&data);
+        ASSERT_TEST(mapPutTake(map, copyInt(&key), taken_data) == MAP_SUCCESS);
+        ASSERT_TEST(mapGet(map, &key) == taken_data && mapGetSize(map) == 11);
+        ASSERT_TEST(mapPut(expected, &key, &data) == MAP_SUCCESS);
+        ASSERT_TEST(mapsHoldTheSame(map, expected));
+        // on failure the caller keeps the elements.
+        ASSERT_TEST(mapPutTake(map, NULL, &data) == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(mapPutTake(map, &key, NULL) == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(mapPutTake(NULL, &key, &data) == MAP_NULL_ARGUMENT);
+        mapDestroy(map);
+        mapDestroy(expected);
+    }
+    Map (*create_inline[])() = {createIntInline, createIntInlineHash};
+    for(int i = 0; i < (int)(sizeof(create_inline) / sizeof(*create_inline)); i++)
+    {
+        Map map = create_inline[i]();
+        int key = 1, data = 2;
+        ASSERT_TEST(mapPutTake(map, &key, &data) == MAP_ERROR && mapIsEmpty(map));
+        mapDestroy(map);
+    }
+    return true;
+}
+
+bool testMapPutBatchMatchesPut()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash, createIntInline};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        Map expected = createIntTree();
+        unsigned int seed = 5;
+        for(int round = 0; round < 3; round++)
+        {
+            // many repeated keys in a random order, so the sort must keep the batch order of equal keys for the
+            // last data of every key to win.
+            int keys[300], data[300];
+            MapKeyElement key_elements[300];
+            MapDataElement data_elements[300];
+            MapResult results[300];
+            for(int j = 0; j < 300; j++)
+            {
+                keys[j] = nextRandom(&seed) % 40 + round * 20;
+                data[j] = round * 1000 + j;
+                key_elements[j] = &keys[j];
+                data_elements[j] = &data[j];
+                ASSERT_TEST(mapPut(expected, &keys[j], &data[j]) == MAP_SUCCESS);
+            }
+            ASSERT_TEST(mapPutBatch(map, key_elements, data_elements, 300, results) == MAP_SUCCESS);
+            for(int j = 0; j < 300; j++)
+            {
+                ASSERT_TEST(results[j] == MAP_SUCCESS);
+            }
+            ASSERT_TEST(mapsHoldTheSame(map, expected));
+        }
+        mapDestroy(map);
+        mapDestroy(expected);
+    }
+    return true;
+}
+
+bool testMapPutBatchResults()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        int keys[] = {5, 3, 5, 1};
+        int data[] = {50, 30, 51, 10};
+        MapKeyElement key_elements[] = {&keys[0], NULL, &keys[2], &keys[3]};
+        MapDataElement data_elements[] = {&data[0], &data[1], &data[2], NULL};
+        MapResult results[4];
+        // the elements without a NULL are put, and every result tells what happened to its element.
+        ASSERT_TEST(mapPutBatch(map, key_elements, data_elements, 4, results) == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(results[0] == MAP_SUCCESS && results[1] == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(results[2] == MAP_SUCCESS && results[3] == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(mapGetSize(map) == 1 && *(int*)mapGet(map, &keys[0]) == 51);
+        ASSERT_TEST(mapPutBatch(map, key_elements, data_elements, 0, results) == MAP_SUCCESS);
+        ASSERT_TEST(mapPutBatch(map, key_elements, data_elements, -1, results) == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(mapPutBatch(map, key_elements, data_elements, 4, NULL) == MAP_NULL_ARGUMENT);
+        ASSERT_TEST(mapPutBatch(NULL, key_elements, data_elements, 4, results) == MAP_NULL_ARGUMENT);
+        mapDestroy(map);
+    }
+    return true;
+}
+
+bool testMapCopyOnWriteIsolation()
+{
+    Map (*create[])() = {createIntTree, createIntHash, createIntInline, createIntInlineHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        for(int key = 0; key < 50; key++)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        }
+        Map copy = mapCopy(map);
+        Map copy_of_copy = mapCopy(copy);
+        ASSERT_TEST(copy != NULL && copy_of_copy != NULL);
+        ASSERT_TEST(mapsHoldTheSame(map, copy) && mapsHoldTheSame(map, copy_of_copy));
+        // data changed through mapGet, mapIterData, mapPut and mapRemove is seen by its own map only.
+        *(int*)mapGet(copy, &(int){1}) = -1;
+        MAP_ITER_FOREACH(iterator, map)
+        {
+            *(int*)mapIterData(&iterator) += 100;
+        }
+        ASSERT_TEST(mapPut(copy_of_copy, &(int){2}, &(int){-2}) == MAP_SUCCESS);
+        ASSERT_TEST(mapRemove(copy, &(int){3}) == MAP_SUCCESS);
+        ASSERT_TEST(mapPut(map, &(int){60}, &(int){60}) == MAP_SUCCESS);
+        for(int key = 0; key < 50; key++)
+        {
+            ASSERT_TEST(*(int*)mapPeek(map, &key) == key + 100);
+            int expected = key == 1 ? -1 : key;
+            ASSERT_TEST(key == 3 ? mapPeek(copy, &key) == NULL : *(int*)mapPeek(copy, &key) == expected);
+            expected = key == 2 ? -2 : key;
+            ASSERT_TEST(*(int*)mapPeek(copy_of_copy, &key) == expected);
+        }
+        ASSERT_TEST(mapGetSize(map) == 51 && mapGetSize(copy) == 49 && mapGetSize(copy_of_copy) == 50);
+        ASSERT_TEST(!mapContains(copy, &(int){60}) && !mapContains(copy_of_copy, &(int){60}));
+        // the copies keep their elements after the maps they share them with are gone.
+        mapDestroy(map);
+        mapDestroy(copy_of_copy);
+        ASSERT_TEST(*(int*)mapGet(copy, &(int){1}) == -1 && *(int*)mapPeek(copy, &(int){49}) == 49);
+        ASSERT_TEST(mapIterMatchesInternalIterator(copy));
+        mapDestroy(copy);
+    }
+    return true;
+}
+
+bool testMapPeekDoesNotCopy()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntInline};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        for(int key = 0; key < 10; key++)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+        }
+        Map copy = mapCopy(map);
+        int* peeked = mapPeek(copy, &(int){5});
+        ASSERT_TEST(peeked != NULL && *peeked == 5 && mapPeek(copy, &(int){5}) == peeked);
+        MAP_ITER_FOREACH(iterator, copy)
+        {
+            ASSERT_TEST(mapIterPeek(&iterator) == mapPeek(copy, mapIterKey(&iterator)));
+        }
+        // the data of a tree is shared until one of the maps writes it, and the list is copied at once.
+        bool shared = i != 0;
+        ASSERT_TEST((mapPeek(map, &(int){5}) == peeked) == shared);
+        int* written = mapGet(copy, &(int){5});
+        ASSERT_TEST(*written == 5 && mapPeek(map, &(int){5}) != written && mapPeek(copy, &(int){5}) == written);
+        ASSERT_TEST(mapPeek(map, &(int){10}) == NULL && mapPeek(NULL, &(int){5}) == NULL);
+        ASSERT_TEST(mapPeek(map, NULL) == NULL && mapIterPeek(NULL) == NULL);
+        mapDestroy(map);
+        mapDestroy(copy);
+    }
+    return true;
+}
+
+bool testMapBoundsOnMissingKeys()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntHash, createIntCollidingHash,
+                         createIntInline, createIntInlineHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        bool present[KEY_RANGE] = {false};
+        for(int key = 10; key < 100; key += 2)
+        {
+            ASSERT_TEST(mapPut(map, &key, &key) == MAP_SUCCESS);
+            present[key] = true;
+        }
+        // missing keys inside the map, present keys, and keys before the first and after the last key.
+        int keys[] = {11, 12, 13, 10, 98, 99, 9, -5, 150};
+        for(int j = 0; j < (int)(sizeof(keys) / sizeof(*keys)); j++)
+        {
+            ASSERT_TEST(mapBoundsStartAt(map, keys[j], present));
+        }
+        ASSERT_TEST(mapRangeVisits(map, 13, 21, present));
+        ASSERT_TEST(mapRangeVisits(map, 12, 20, present));
+        ASSERT_TEST(mapRangeVisits(map, -5, 11, present));
+        ASSERT_TEST(mapRangeVisits(map, 95, 150, present));
+        ASSERT_TEST(mapRangeVisits(map, 13, 13, present));
+        ASSERT_TEST(mapRangeVisits(map, 100, 150, present));
+        ASSERT_TEST(mapRangeVisits(map, 0, 9, present));
+        // a range whose low key is greater than its high key is empty.
+        ASSERT_TEST(mapRangeVisits(map, 30, 20, present));
+        MapIterator null_iterator = mapLowerBound(map, NULL);
+        ASSERT_TEST(mapIterKey(&null_iterator) == NULL && !mapIterFailed(&null_iterator));
+        null_iterator = mapUpperBound(NULL, &(int){1});
+        ASSERT_TEST(mapIterKey(&null_iterator) == NULL);
+        null_iterator = mapIterRange(map, &(int){1}, NULL);
+        ASSERT_TEST(mapIterKey(&null_iterator) == NULL);
+        mapDestroy(map);
+    }
+    return true;
+}
+
+bool testMapRangeAfterPutAndRemove()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntCollidingHash, createIntInline};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        ASSERT_TEST(mapCheckInterleavedPutRemove(map, 13));
+        bool present[KEY_RANGE] = {false};
+        MAP_FOREACH(int*, key, map)
+        {
+            present[*key] = true;
+            free(key);
+        }
+        unsigned int seed = 17;
+        for(int j = 0; j < 50; j++)
+        {
+            int low = nextRandom(&seed) % (KEY_RANGE + 20) - 10;
+            int high = low + nextRandom(&seed) % 60;
+            ASSERT_TEST(mapRangeVisits(map, low, high, present));
+            ASSERT_TEST(mapBoundsStartAt(map, low, present));
+        }
+        // data of a range can be changed through the iterator.
+        MAP_RANGE_FOREACH(iterator, map, &(int){50}, &(int){59})
+        {
+            *(int*)mapIterData(&iterator) = -1;
+        }
+        MAP_ITER_FOREACH(iterator, map)
+        {
+            int key = *(int*)mapIterKey(&iterator);
+            ASSERT_TEST((*(int*)mapIterPeek(&iterator) == -1) == (key >= 50 && key <= 59));
+        }
+        mapDestroy(map);
+    }
+    return true;
+}
+
+bool testMapIterUnorderedVisitsEveryKey()
+{
+    Map (*create[])() = {createIntList, createIntTree, createIntCollidingHash, createIntInlineHash};
+    for(int i = 0; i < (int)(sizeof(create) / sizeof(*create)); i++)
+    {
+        Map map = create[i]();
+        MapIterator empty_iterator = mapIterBeginUnordered(map);
+        ASSERT_TEST(mapIterKey(&empty_iterator) == NULL && !mapIterFailed(&empty_iterator));
+        ASSERT_TEST(mapCheckInterleavedPutRemove(map, 19));
+        bool visited[KEY_RANGE] = {false};
+        int count = 0;
+        for(MapIterator iterator = mapIterBeginUnordered(map); mapIterKey(&iterator); mapIterNext(&iterator))
+        {
+            int key = *(int*)mapIterKey(&iterator);
+            ASSERT_TEST(mapContains(map, &key) && !visited[key]);
+            ASSERT_TEST(mapIterPeek(&iterator) == mapPeek(map, &key));
+            visited[key] = true;
+            count++;
+        }
+        ASSERT_TEST(count == mapGetSize(map));
+        mapDestroy(map);
+    }
+    MapIterator null_iterator = mapIterBeginUnordered(NULL);
+    ASSERT_TEST(mapIterKey(&null_iterator) == NULL);
+    return true;
+}
+
+/*The functions for the tests should be added here*/
+bool (*tests[]) (void) = {
+        testMapTreeOrderAfterPutAndRemove,
+        testMapTreeBalancedOnSortedInput,
+        testMapTreeMatchesList,
+        testMapTreeCopy,
+        testMapTreeNullArguments,
+        testMapHashOrderAfterPutAndRemove,
+        testMapHashMatchesTree,
+        testMapHashCopy,
+        testMapIterOrderAfterPutAndRemove,
+        testMapIterNested,
+        testMapSizeAndIsEmpty,
+        testMapAllocationStatistics,
+        testMapInlineMatchesTree,
+        testMapInlineStoresCopies,
+        testMapInlineCreate,
+        testMapPutTake,
+        testMapPutBatchMatchesPut,
+        testMapPutBatchResults,
+        testMapCopyOnWriteIsolation,
+        testMapPeekDoesNotCopy,
+        testMapBoundsOnMissingKeys,
+        testMapRangeAfterPutAndRemove,
+        testMapIterUnorderedVisitsEveryKey
+};
+
+/*The names of the test functions should be added here*/
+const char* testNames[] = {
+        "testMapTreeOrderAfterPutAndRemove",
+        "testMapTreeBalancedOnSortedInput",
+        "testMapTreeMatchesList",
+        "testMapTreeCopy",
+        "testMapTreeNullArguments",
+        "testMapHashOrderAfterPutAndRemove",
+        "testMapHashMatchesTree",
+        "testMapHashCopy",
+        "testMapIterOrderAfterPutAndRemove",
+        "testMapIterNested",
+        "testMapSizeAndIsEmpty",
+        "testMapAllocationStatistics",
+        "testMapInlineMatchesTree",
+        "testMapInlineStoresCopies",
+        "testMapInlineCreate",
+        "testMapPutTake",
+        "testMapPutBatchMatchesPut",
+        "testMapPutBatchResults",
+        "testMapCopyOnWriteIsolation",
+        "testMapPeekDoesNotCopy",
+        "testMapBoundsOnMissingKeys",
+        "testMapRangeAfterPutAndRemove",
+        "testMapIterUnorderedVisitsEveryKey"
+};
+
+#define NUMBER_TESTS ((long)(sizeof(tests)/sizeof(*tests)))
+
+int main(int argc, char *argv[]) {
+    int failed_tests = 0;
+    if (argc == 1) {
+        for (int test_idx = 0; test_idx < NUMBER_TESTS; test_idx++) {
+            RUN_TEST(tests[test_idx], testNames[test_idx]);
+        }
+        return failed_tests == 0 ? 0 : 1;
+    }
+    if (argc != 2) {
+        fprintf(stdout, "Usage: map_test <test index>\n");
+        return 0;
+    }
+
+    int test_idx = strtol(argv[1], NULL, 10);
+    if (test_idx < 1 || test_idx > NUMBER_TESTS) {
+        fprintf(stderr, "Invalid test index %d\n", test_idx);
+        return 0;
+    }
+
+    RUN_TEST(tests[test_idx - 1], testNames[test_idx - 1]);
+    return failed_tests == 0 ? 0 : 1;
+}
@@ -0,0 +1,47 @@
+#ifndef TEST_UTILITIES_H_
+#define TEST_UTILITIES_H_
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * These macros are here to help you create tests more easily and keep them
+ * clear.
+ *
+ * The basic idea with unit-testing is create a test function for every real
+ * function and inside the test function declare some variables and execute the
+ * function under test.
+ *
+ * Use the ASSERT_TEST to verify correctness of values.
+ */
+
+/**
+ * Evaluates expr and continues if expr is true.
+ * If expr is false, ends the test by returning false and prints a detailed
+ * message about the failure.
+ */
+#define ASSERT_TEST(expr)                                                      \
+    do {                                                                       \
+        if (!(expr)) {                                                         \
+            printf("\nAssertion failed at %s:%d %s ", __FILE__, __LINE__,      \
+                   #expr);                                                     \
+            return false;                                                      \
+        }                                                                      \
+    } while (0)
+
+/**
+ * Macro used for running a test from the main function. Counts the failed
+ * tests in failed_tests, which the main function declares.
+ */
+#define RUN_TEST(test, name)                                                   \
+    do {                                                                       \
+        printf("Running %s ... ", name);                                       \
+        if (test()) {                                                          \
+            printf("[OK]\n");                                                  \
+        } else {                                                               \
+            printf("[Failed]\n");                                              \
+            failed_tests++;                                                    \
+        }                                                                      \
+    } while (0)
+
+#endif /* TEST_UTILITIES_H_ */
@@ -3,24 +3,147 @@
 #include <string.h>
 #include "tournament.h"
 #include "map.h"
-#include "list.h"
 #include "game.h"
 #include "player.h"
 
 struct tournament_t {
     int tournament_id;
-    List games;
+    Games games;
+    long long total_game_time;  // games are never removed, so their time statistics are kept as they are added
+    int longest_game_time;
     bool status;
     char* tournament_location;
     int winner_id;
     int max_games_allowed;
-    List players_list;
+    Map players;  // player id -> struct player_t of every player who has games in the tournament, stored inline
+    Map standings;  // struct player_t of every player in players, ordered by score. empty once the tournament ended
     int removed_players_counter;
+    Map played_pairings;  // the GamePairing of every game in which neither player was removed
+    Map game_chains;  // player id -> GameChain of every player in players
 };
 
+// the first and last of the games of a player in a tournament. the games in between are linked by the games store.
+typedef struct game_chain_t {
+    int first;
+    int last;
+} GameChain;
+
+// the players of a game, ordered so a game has the same pairing whichever player was first.
+typedef struct game_pairing_t {
+    int low_id;
+    int high_id;
+} GamePairing;
+
 
 // HELPER FUNCTIONS START
 
+static GamePairing gamePairingCreate(int player1, int player2)
+{
+    GamePairing pairing;
+    pairing.low_id = player1 < player2 ? player1 : player2;
+    pairing.high_id = player1 < player2 ? player2 : player1;
+    return pairing;
+}
+
+// Functions to be used by the map of played pairings
+static int compareGamePairings(MapKeyElement pairing1, MapKeyElement pairing2)
+{
+    GamePairing* first = pairing1;
+    GamePairing* second = pairing2;
+    if(first->low_id != second->low_id)
+    {
+        return first->low_id < second->low_id ? -1 : 1;
+    }
+    if(first->high_id != second->high_id)
+    {
+        return first->high_id < second->high_id ? -1 : 1;
+    }
+    return 0;
+}
+
+static unsigned int hashGamePairing(MapKeyElement pairing)
+{
+    return (unsigned int)((GamePairing*)pairing)->low_id * 31u + (unsigned int)((GamePairing*)pairing)->high_id;
+}
+
+// Functions to be used by the map of players
+static int comparePlayerIds(MapKeyElement id1, MapKeyElement id2)
+{
+    return *(int*)id1 - *(int*)id2;
+}
+
+static unsigned int hashPlayerId(MapKeyElement id)
+{
+    return (unsigned int)*(int*)id;
+}
+
+// adds a player with no games to the players map, the standings and the game chains, unless he already exists.
+// returns false on memory allocation error.
+static bool tournamentReservePlayer(Tournament tournament, int player_id)
+{
+    if(mapContains(tournament->players, &player_id))
+    {
+        return true;
+    }
+    struct player_t player = {player_id, 0, 0, 0, 0};
+    GameChain chain = {NO_NEXT_GAME, NO_NEXT_GAME};
+    if(mapPut(tournament->players, &player_id, &player) != MAP_SUCCESS)
+    {
+        return false;
+    }
+    if(mapPut(tournament->standings, &player, &player) != MAP_SUCCESS ||
+       mapPut(tournament->game_chains, &player_id, &chain) != MAP_SUCCESS)
+    {
+        mapRemove(tournament->standings, &player);
+        mapRemove(tournament->players, &player_id);
+        return false;
+    }
+    return true;
+}
+
+// removes a player from the players map, the standings and the game chains.
+static void tournamentDropPlayer(Tournament tournament, int player_id)
+{
+    Player player = mapPeek(tournament->players, &player_id);
+    if(player != NULL)
+    {
+        mapRemove(tournament->standings, player);
+        mapRemove(tournament->players, &player_id);
+        mapRemove(tournament->game_chains, &player_id);
+    }
+}
+
+// appends the game_index-th game to the chain of games of player_id, who was reserved before the game was added.
+static void tournamentChainGame(Tournament tournament, int player_id, int game_index)
+{
+    if(player_id == PLAYER_REMOVED)
+    {
+        return;
+    }
+    GameChain* chain = mapGet(tournament->game_chains, &player_id);
+    if(chain->last == NO_NEXT_GAME)
+    {
+        chain->first = game_index;
+    }
+    else
+    {
+        gamesSetNextOfPlayer(tournament->games, chain->last, player_id, game_index);
+    }
+    chain->last = game_index;
+}
+
+// moves a player to his place in the standings after his results changed from old_record. the node of the old
+// record is reused, so this can not fail.
+static void tournamentUpdateStandings(Tournament tournament, Player old_record, Player new_record)
+{
+    if(getTournamentStatus(tournament) == DONE)
+    {
+        return;
+    }
+    mapRemove(tournament->standings, old_record);
+    mapPut(tournament->standings, new_record, new_record);
+}
+
 /**
  * tournamentAddPlayer: stupid function to add or update a player's data. You only insert players when adding games
  *                      so there is always information regarding the result of the game. assumes player_id is valid.
@@ -30,12 +153,14 @@ struct tournament_t {
  * @param win - true if he won.
  * @param lose - true if he lost.
  * @param draw  - true if there was a draw.
+ * @param play_time - the time of the game.
  * @return
  *   TOURNAMENT_NULL_ARGUMENTS if one of the arguments is NULL.
  *   TOURNAMENT_INVALID_ARGUMENTS if win, lose and draw are all false or if more than one are true.
  *   TOUNAMENT_SUCCESS otherwise.
 */
-static TournamentError tournamentAddPlayer(Tournament tournament, int player_id, bool win, bool lose, bool draw)
+static TournamentError tournamentAddPlayer(Tournament tournament, int player_id, bool win, bool lose, bool draw,
+                                           int play_time)
 {
     if(tournament == NULL)
     {
@@ -45,66 +170,40 @@ static TournamentError tournamentAddPlayer(Tournament tournament, int player_id,
     {
         return TOURNAMENT_INVALID_ARGUMENTS;
     }
-    List iterator = tournament->players_list;
-    if(listGetData(iterator) == NULL)  // no players in list, add the first
-    {
-        Player player = playerCreate(player_id, win, lose, draw);
-        if(player == NULL)
-        {
-            return TOURNAMENT_OUT_OF_MEMORY;
-        }
-        listSet(iterator, player);
-        return TOURNAMENT_SUCCESS;
-    }
-    while(iterator)  // at least one player in list
-    {
-        Player player = listGetData(iterator);
-        if(player->id == player_id)
-        {
-            player->wins += win;
-            player->losses += lose;
-            player->draws += draw;
-            return TOURNAMENT_SUCCESS;
-        }
-        iterator = iterator->next;
-    }
-    // player does not exist in players_list. create him.
-    Player player = playerCreate(player_id, win, lose, draw);
-    List new_node = listAdd(tournament->players_list);
-    if(new_node == NULL)
+    if(!tournamentReservePlayer(tournament, player_id))
     {
         return TOURNAMENT_OUT_OF_MEMORY;
     }
-    listSet(new_node, player);  // no copying here so no need to free player.
+    Player player = mapGet(tournament->players, &player_id);
+    struct player_t old_record = *player;
+    player->wins += win;
+    player->losses += lose;
+    player->draws += draw;
+    player->play_time += play_time;
+    tournamentUpdateStandings(tournament, &old_record, player);
     return TOURNAMENT_SUCCESS;
 }
 
-// runs through all games in a tournament and calculates for each player attending: wins, losses and draws.
-static TournamentError tournamentUpdatePlayersList(Tournament tournament)
+// sets the winner of a game whose other player is being removed to opponent_side, and moves the result in the
+// opponent's statistics accordingly. on_opponent_win is called if the result changed.
+static void tournamentGiveWinToOpponent(Tournament tournament, Game game, Winner opponent_side, int opponent_id,
+                                        opponentWinCallback on_opponent_win, void* context)
 {
-    List new_players_list = listCreate((freeListDataElement)playerDestroy, (copyListDataElement)playerCopy);
-    if(new_players_list == NULL)
-    {
-        return TOURNAMENT_OUT_OF_MEMORY;
-    }
-    listDestroy(tournament->players_list);
-    tournament->players_list = new_players_list;
-    List iterator = tournament->games;
-    while(iterator)
+    Player opponent = mapGet(tournament->players, &opponent_id);  // NULL if the opponent was removed as well
+    Winner winner = getWinner(game);
+    if(opponent != NULL && winner != opponent_side)
     {
-        Game game = listGetData(iterator);
-        if(game == NULL)  // no games in tournament
+        struct player_t old_record = *opponent;
+        opponent->draws -= (winner == DRAW);
+        opponent->losses -= (winner != DRAW);
+        opponent->wins++;
+        tournamentUpdateStandings(tournament, &old_record, opponent);
+        if(on_opponent_win != NULL)
         {
-            return TOURNAMENT_SUCCESS;
+            on_opponent_win(context, opponent_id, winner == DRAW);
         }
-        Winner winner = getWinner(game);
-        tournamentAddPlayer(tournament, getPlayer1ID(game), winner == FIRST_PLAYER, 
-                            winner == SECOND_PLAYER, winner == DRAW);
-        tournamentAddPlayer(tournament, getPlayer2ID(game), winner == SECOND_PLAYER, 
-                            winner == FIRST_PLAYER, winner == DRAW);
-        iterator = iterator->next;
     }
-    return TOURNAMENT_SUCCESS;
+    setWinner(game, opponent_side);
 }
 
 // HELPER FUNCTIONS END
@@ -117,6 +216,13 @@ Tournament createTournament(int tournament_id, const char* tournament_location,
         return NULL;
     }
     tournament->tournament_id = tournament_id;
+    tournament->games = NULL;
+    tournament->total_game_time = 0;
+    tournament->longest_game_time = 0;
+    tournament->players = NULL;
+    tournament->standings = NULL;
+    tournament->played_pairings = NULL;
+    tournament->game_chains = NULL;
     tournament->tournament_location = malloc(sizeof(char) * (strlen(tournament_location)+1));
     if(tournament->tournament_location == NULL)
     {
@@ -125,7 +231,7 @@ Tournament createTournament(int tournament_id, const char* tournament_location,
     }
     strcpy(tournament->tournament_location, tournament_location);
     
-    tournament->games = listCreate((freeListDataElement)gameDestroy, (copyListDataElement)gameCopy);
+    tournament->games = gamesCreate();
     if(tournament->games == NULL)
     {
         tournamentDestroy(tournament);
@@ -136,8 +242,19 @@ Tournament createTournament(int tournament_id, const char* tournament_location,
     tournament->max_games_allowed = max_games;
     tournament->status = IN_PROCCESS;
     tournament->removed_players_counter = 0;
-    tournament->players_list = listCreate((freeListDataElement)playerDestroy, (copyListDataElement)playerCopy);
-    if(tournament->players_list == NULL)
+    // players are small structs without pointers, so they are stored inside the map.
+    tournament->players = mapCreateInlineHash(sizeof(int), sizeof(struct player_t), comparePlayerIds, hashPlayerId);
+    tournament->standings = mapCreateInline(sizeof(struct player_t), sizeof(struct player_t),
+                                            (compareMapKeyElements)playerCompareScore);
+    tournament->game_chains = mapCreateInlineHash(sizeof(int), sizeof(GameChain), comparePlayerIds, hashPlayerId);
+    if(tournament->players == NULL || tournament->standings == NULL || tournament->game_chains == NULL)
+    {
+        tournamentDestroy(tournament);
+        return NULL;
+    }
+    // a set of pairings, so the map holds no data.
+    tournament->played_pairings = mapCreateInlineHash(sizeof(GamePairing), 0, compareGamePairings, hashGamePairing);
+    if(tournament->played_pairings == NULL)
     {
         tournamentDestroy(tournament);
         return NULL;
@@ -151,8 +268,11 @@ void tournamentDestroy(Tournament tournament)
     {
         return;
     }
-    listDestroy(tournament->games);
-    listDestroy(tournament->players_list);
+    gamesDestroy(tournament->games);
+    mapDestroy(tournament->players);
+    mapDestroy(tournament->standings);
+    mapDestroy(tournament->played_pairings);
+    mapDestroy(tournament->game_chains);
     free(tournament->tournament_location);
     free(tournament);
 
@@ -161,20 +281,51 @@ void tournamentDestroy(Tournament tournament)
 TournamentError tournamentAddGame(Tournament tournament, int first_player, int second_player,
                                   Winner winner, int play_time)
 {
-    Game game = gameCreate(first_player, second_player, winner, play_time);
-    if(game == NULL)
+    // a restored game may have removed players, who have no pairing and no record.
+    bool is_pairing = first_player != PLAYER_REMOVED && second_player != PLAYER_REMOVED;
+    GamePairing pairing = gamePairingCreate(first_player, second_player);
+    if(is_pairing && mapPut(tournament->played_pairings, &pairing, &pairing) != MAP_SUCCESS)
     {
         return TOURNAMENT_OUT_OF_MEMORY;
     }
-    List new_list = listAdd(tournament->games);
-    if(new_list == NULL)
+    // the players are added before the game, so updating them below can not fail.
+    bool first_is_new = first_player != PLAYER_REMOVED && !mapContains(tournament->players, &first_player);
+    bool second_is_new = second_player != PLAYER_REMOVED && !mapContains(tournament->players, &second_player);
+    GameErrors result = GAME_OUT_OF_MEMORY;
+    if((first_player == PLAYER_REMOVED || tournamentReservePlayer(tournament, first_player)) &&
+       (second_player == PLAYER_REMOVED || tournamentReservePlayer(tournament, second_player)))
     {
+        result = gamesAdd(tournament->games, first_player, second_player, winner, play_time);
+    }
+    if(result != GAME_SUCCESS)
+    {
+        if(first_is_new)
+        {
+            tournamentDropPlayer(tournament, first_player);
+        }
+        if(second_is_new)
+        {
+            tournamentDropPlayer(tournament, second_player);
+        }
+        if(is_pairing)
+        {
+            mapRemove(tournament->played_pairings, &pairing);
+        }
         return TOURNAMENT_OUT_OF_MEMORY;
     }
-    listSet(new_list, game);
-    // adding the players to the players map
-    tournamentAddPlayer(tournament, first_player, winner == FIRST_PLAYER, winner == SECOND_PLAYER, winner == DRAW);
-    tournamentAddPlayer(tournament, second_player, winner == SECOND_PLAYER, winner == FIRST_PLAYER, winner == DRAW);
+    int game_index = gamesGetCount(tournament->games) - 1;
+    tournamentChainGame(tournament, first_player, game_index);
+    tournamentChainGame(tournament, second_player, game_index);
+    tournament->total_game_time += play_time;
+    if(play_time > tournament->longest_game_time)
+    {
+        tournament->longest_game_time = play_time;
+    }
+    // updating the players in the players map
+    tournamentAddPlayer(tournament, first_player, winner == FIRST_PLAYER, winner == SECOND_PLAYER, winner == DRAW,
+                        play_time);
+    tournamentAddPlayer(tournament, second_player, winner == SECOND_PLAYER, winner == FIRST_PLAYER, winner == DRAW,
+                        play_time);
     return TOURNAMENT_SUCCESS;
 }
 
@@ -200,6 +351,20 @@ TournamentStatus getTournamentStatus(Tournament tournament)
 void setTournamentStatus(Tournament tournament, TournamentStatus status)
 {
     tournament->status = status;
+    if(status == DONE)  // the winner is decided, so the standings are not needed anymore.
+    {
+        mapClear(tournament->standings);
+    }
+}
+
+Player tournamentGetLeader(Tournament tournament)
+{
+    if(tournament == NULL || getTournamentStatus(tournament) == DONE)
+    {
+        return NULL;
+    }
+    MapIterator leader_iterator = mapIterBegin(tournament->standings);
+    return mapIterKey(&leader_iterator);
 }
 
 int getTournamentMaxGamesAllowed(Tournament tournament)
@@ -209,51 +374,65 @@ int getTournamentMaxGamesAllowed(Tournament tournament)
 
 bool doesTournamentHasGames(Tournament tournament)
 {
-    return listGetData(tournament->games) != NULL;
+    return gamesGetCount(tournament->games) > 0;
+}
+
+Games getTournamentGames(Tournament tournament)
+{
+    return tournament->games;
+}
+
+int getTournamentRemovedPlayers(Tournament tournament)
+{
+    return tournament->removed_players_counter;
 }
 
-List getTournamentPlayersList(Tournament tournament)
+void setTournamentRemovedPlayers(Tournament tournament, int removed_players)
 {
-    return tournament->players_list;
+    tournament->removed_players_counter = removed_players;
 }
 
-int tournamentRemovePlayer(Tournament tournament, int player_id)
+Map getTournamentPlayersMap(Tournament tournament)
+{
+    return tournament->players;
+}
+
+int tournamentRemovePlayer(Tournament tournament, int player_id, opponentWinCallback on_opponent_win, void* context)
 {
     if(tournament == NULL)
     {
         return 0;
     }
-    List iterator = tournament->games;
+    // only the games of the player are visited, by following his chain of games.
+    GameChain* chain = mapPeek(tournament->game_chains, &player_id);
+    int next_index = chain == NULL ? NO_NEXT_GAME : chain->first;
     int instances_removed = 0;
-    while(iterator != NULL)
+    while(next_index != NO_NEXT_GAME)
     {
-        Game game = listGetData(iterator);
-        if(game == NULL)  // no games in tournament
-        {
-            return 0;
-        }
+        struct game_t game_view = gamesGet(tournament->games, next_index);
+        Game game = &game_view;
+        next_index = gamesGetNextOfPlayer(tournament->games, game_view.index, player_id);  // before his id is removed
+        GamePairing pairing = gamePairingCreate(getPlayer1ID(game), getPlayer2ID(game));
+        mapRemove(tournament->played_pairings, &pairing);
         if(getPlayer1ID(game) == player_id)
         {
             setPlayer1(game, PLAYER_REMOVED);
             if(getTournamentStatus(tournament) == IN_PROCCESS)
             {
-                setWinner(game, SECOND_PLAYER);
+                tournamentGiveWinToOpponent(tournament, game, SECOND_PLAYER, getPlayer2ID(game), on_opponent_win, context);
             }
-            instances_removed += 1;
         }
-        else if(getPlayer2ID(game) == player_id)
+        else
         {
             setPlayer2(game, PLAYER_REMOVED);
             if(getTournamentStatus(tournament) == IN_PROCCESS)
             {
-                setWinner(game, FIRST_PLAYER);
+                tournamentGiveWinToOpponent(tournament, game, FIRST_PLAYER, getPlayer1ID(game), on_opponent_win, context);
             }
-            instances_removed += 1;
         }
-        iterator = iterator->next;
+        instances_removed += 1;
     }
-    // assuming no memory errors because its hard to take care of.
-    tournamentUpdatePlayersList(tournament);
+    tournamentDropPlayer(tournament, player_id);
     if(instances_removed > 0) {
         tournament->removed_players_counter++;
     }
@@ -268,19 +447,32 @@ Tournament tournamentCopy(Tournament tournament)
     }
     Tournament new_tournament = createTournament(tournament->tournament_id, tournament->tournament_location, 
                                                  tournament->max_games_allowed);
+    if(new_tournament == NULL)
+    {
+        return NULL;
+    }
     new_tournament->status = tournament->status;
     new_tournament->winner_id = tournament->winner_id;
-    if(listGetData(tournament->games) != NULL)  // there are games to copy
+    new_tournament->removed_players_counter = tournament->removed_players_counter;
+    new_tournament->total_game_time = tournament->total_game_time;
+    new_tournament->longest_game_time = tournament->longest_game_time;
+    mapDestroy(new_tournament->played_pairings);
+    new_tournament->played_pairings = mapCopy(tournament->played_pairings);
+    mapDestroy(new_tournament->players);
+    new_tournament->players = mapCopy(tournament->players);
+    mapDestroy(new_tournament->standings);
+    new_tournament->standings = mapCopy(tournament->standings);
+    mapDestroy(new_tournament->game_chains);
+    new_tournament->game_chains = mapCopy(tournament->game_chains);
+    if(new_tournament->played_pairings == NULL || new_tournament->players == NULL ||
+       new_tournament->standings == NULL || new_tournament->game_chains == NULL)
     {
-        ListError result = listCopy(tournament->games, new_tournament->games);
-        if(result == LIST_MEMORY_ERROR)
-        {
-            tournamentDestroy(new_tournament);
-            return NULL;
-        }
+        tournamentDestroy(new_tournament);
+        return NULL;
     }
-    ListError result = listCopy(tournament->players_list, new_tournament->players_list);
-    if(result == LIST_MEMORY_ERROR)
+    gamesDestroy(new_tournament->games);
+    new_tournament->games = gamesCopy(tournament->games);
+    if(new_tournament->games == NULL)
     {
         tournamentDestroy(new_tournament);
         return NULL;
@@ -290,21 +482,8 @@ Tournament tournamentCopy(Tournament tournament)
 
 bool doesGameExist(Tournament tournament, int player1, int player2)
 { 
-    List iterator = tournament->games;
-    if(listGetData(iterator) == NULL)  // no games in tournament
-    {
-        return false;
-    }
-    while(iterator)
-    {
-        if ((getPlayer1ID(iterator->data) == player1 && getPlayer2ID(iterator->data) == player2) ||
-            (getPlayer1ID(iterator->data) == player2 && getPlayer2ID(iterator->data) == player1))
-        {
-            return true;
-        }
-        iterator = iterator->next;
-    }
-    return false;
+    GamePairing pairing = gamePairingCreate(player1, player2);
+    return mapContains(tournament->played_pairings, &pairing);
 }
 
 int tournamentCountGames(Tournament tournament, int player_id)
@@ -314,21 +493,7 @@ int tournamentCountGames(Tournament tournament, int player_id)
         return 0;
     }
 
-    int games_counter = 0;
-    List iterator = tournament->games;
-    if(listGetData(iterator) == NULL)  // no games in tournament
-    {
-        return 0;
-    }
-    while(iterator)
-    {
-        if(getPlayer1ID(iterator->data) == player_id || getPlayer2ID(iterator->data) == player_id)
-        {
-            games_counter += 1;
-        }
-        iterator = iterator->next;
-    }
-    return games_counter;
+    return getTotalGamesPlayed(mapPeek(tournament->players, &player_id));
 }
 
 int tournamentCalculateGameTime(Tournament tournament, int player_id)
@@ -337,52 +502,26 @@ int tournamentCalculateGameTime(Tournament tournament, int player_id)
     {
         return 0;
     }
-    int total_game_time = 0;
-    List games_iterator = tournament->games;
-    while(games_iterator)
-    {
-        Game game = listGetData(games_iterator);
-        if(game == NULL)  // no games in tournament
-        {
-            return 0;
-        }
-        if(getPlayer1ID(game) == player_id || getPlayer2ID(game) == player_id)
-        {
-            total_game_time += getGameTime(game);
-        }
-        games_iterator = games_iterator->next;
-    }
-    return total_game_time;
+    Player player = mapPeek(tournament->players, &player_id);
+    return player == NULL ? 0 : player->play_time;
 }
 
 TournamentError getTournamentStatistics(Tournament tournament, int* longest_game_time, double* average_game_time,
                                         int* number_of_games, int* number_of_players)
 {
     *number_of_players = tournament->removed_players_counter;
-    *number_of_players += (listGetData(tournament->players_list) != NULL) * listGetSize(tournament->players_list);
-    // ^ number of nodes in the list but there is always at least 1 because of stupid implementation.
+    *number_of_players += mapGetSize(tournament->players);
     *number_of_games = 0;
     *longest_game_time = 0;
     *average_game_time = 0;
-    List iterator = tournament->games;
-    if(listGetData(iterator) == NULL)  // no games in tournament, avoid dividing by zero.
+    *number_of_games = gamesGetCount(tournament->games);
+    if(*number_of_games == 0)  // no games in tournament, avoid dividing by zero.
     {
         *number_of_players = 0;
         return TOURNAMENT_SUCCESS;
     }
-    while(iterator)
-    {
-        Game game = listGetData(iterator);
-        if(game != NULL)
-        {
-            *number_of_games += 1;
-            int game_time = getGameTime(game);
-            *longest_game_time = *longest_game_time > game_time ? *longest_game_time : game_time;
-            *average_game_time += game_time;
-        }
-        iterator = iterator->next;
-    }
-    *average_game_time = *average_game_time/(double)(*number_of_games);
+    *longest_game_time = tournament->longest_game_time;
+    *average_game_time = (double)tournament->total_game_time/(double)(*number_of_games);
     return TOURNAMENT_SUCCESS;
 }
 
@@ -394,7 +533,7 @@ char* getTournamentLocation(Tournament tournament)
 // bool tournamentDoesPlayerExist(Tournament tournament, int player_id)
 // {
 //     // assuming tournament and player_id are valid
-//     List iterator = tournament->players_list;
+//     List iterator = tournament->players;
 //     while(iterator)
 //     {
 //         Player player = listGetData(iterator);
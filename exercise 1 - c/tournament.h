@@ -3,7 +3,7 @@
 
 #include "game.h"
 #include "map.h"
-#include "list.h"
+#include "player.h"
 
 #define NO_WINNER -1
 
@@ -45,8 +45,8 @@ void tournamentDestroy(Tournament tournament);
  * tournamentAddGame: adds a game to the tournament.
  *
  * @param tournament - target tournament. must not be NULL.
- * @param first_player - first player in the game
- * @param second_player - second player in the game
+ * @param first_player - first player in the game. may be PLAYER_REMOVED when a saved game is restored.
+ * @param second_player - second player in the game. may be PLAYER_REMOVED when a saved game is restored.
  * @param winner - the winner of the game. must be of enum Winner.
  * @param play_time - time it took the game to complete.
  * @return
@@ -55,13 +55,20 @@ void tournamentDestroy(Tournament tournament);
 TournamentError tournamentAddGame(Tournament tournament,int first_player, int second_player,
                                   Winner winner, int play_time);
 
+// called by tournamentRemovePlayer when opponent_id gets the win of a game he lost, or drew if was_draw is true.
+typedef void (*opponentWinCallback)(void* context, int opponent_id, bool was_draw);
+
 /** tournamentemovePlayer: removes a given player from the touranment. his id is removed in all of the games he played
- * and if the tournament isn't over, his oppnent gets the win.
+ * and if the tournament isn't over, his oppnent gets the win. only the games of the player are visited, so this
+ * takes O(games of the player) and not O(games of the tournament).
  * @param tournament - target tournament. must not be NULL.
  * @param player_id - id of the player to remove from the tournament.
+ * @param on_opponent_win - called with context for every game whose result changes, before the next game is
+ *                          changed. may be NULL.
+ * @param context - passed to on_opponent_win.
  * @return
  *      number of games the player was removed from. 0 if allocation error occured. **/
-int tournamentRemovePlayer(Tournament tournament, int player_id);
+int tournamentRemovePlayer(Tournament tournament, int player_id, opponentWinCallback on_opponent_win, void* context);
 
 /** tournamentCopy: creates a new tournament, identical to given tournament.
  * @param tournament - target tournament. must not be NULL.
@@ -142,35 +149,55 @@ char* getTournamentLocation(Tournament tournament);
 void setTournamentStatus(Tournament tournament, TournamentStatus status);
 
 /**
- * getTournamentPlayersMap: returns the players_map associated with the given tournament
+ * getTournamentPlayersMap: returns the players map associated with the given tournament. the map's keys are
+ *                          player ids and its data are struct player_t records, which are stored inside the map.
+ *                          the records must not be changed.
  *
  * @param tournament - target tournament. must not be NULL.
  * @return
- *   tournament->players_map
+ *   tournament->players
 */
 Map getTournamentPlayersMap(Tournament tournament);
 
+// getter function. returns the games of the tournament, in the order they were added.
+Games getTournamentGames(Tournament tournament);
+
+// getter function. returns the amount of players who were removed from the tournament after playing in it.
+int getTournamentRemovedPlayers(Tournament tournament);
+
+// setter function. used when a saved tournament is restored.
+void setTournamentRemovedPlayers(Tournament tournament, int removed_players);
+
+/**
+ * tournamentGetLeader: returns the player with the best score in a tournament which is in process, who would win
+ *                      it if it ended now. the standings are kept ordered as games are added and players are
+ *                      removed, so this takes O(log n).
+ *
+ * @param tournament - target tournament.
+ * @return
+ *   NULL if tournament is NULL, if it ended or if it has no players. the leader's record otherwise, which must not
+ *   be changed.
+*/
+Player tournamentGetLeader(Tournament tournament);
+
 // returns true if at least one game in tournament. false otherwise.
 bool doesTournamentHasGames(Tournament tournament);
 
-// counts the number of games player_id played in the given tournament.
+// returns the number of games player_id played in the given tournament, in O(1).
 int tournamentCountGames(Tournament tournament, int player_id);
 
 /**
- * getTournamentStatistics: calculates the tournament's statistics. the results are returned through
- * the given pointers.
+ * getTournamentStatistics: returns the tournament's statistics, which are kept as games are added and players are
+ * removed, in O(1). the results are returned through the given pointers.
  * @return
  *  basically always CHESS_SUCCESS.
 */
 TournamentError getTournamentStatistics(Tournament tournament, int* longest_game_time, double* average_game_time,
                                         int* number_of_games, int* number_of_players);
 
-// calculates the avereage game time of a given player.
+// returns the total time of the games player_id played in the given tournament, in O(1).
 int tournamentCalculateGameTime(Tournament tournament, int player_id);
 
-// getter function. returns tournament->players_list
-List getTournamentPlayersList(Tournament tournament);
-
 // checks if a player played in the tournament.
 // bool tournamentDoesPlayerExist(Tournament tournament, int player_id);
 
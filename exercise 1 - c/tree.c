@@ -0,0 +1,731 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tree.h"
+
+// nodes which may be copied by a single change of a shared tree, per level of the tree: a node on the path
+// and two nodes of a rotation, each of which may also need a shared element.
+#define TREE_COPIES_PER_LEVEL 6
+
+// used for rounding the sizes of inline elements, so every element is aligned for any type.
+typedef union tree_alignment_t {
+    long double long_double_member;
+    long long long_long_member;
+    void* pointer_member;
+} TreeAlignment;
+
+// the key and data of nodes of several trees, after a node was copied. allocated from the pool of the nodes.
+struct tree_element_t {
+    TreeKeyElement key;
+    TreeDataElement data;
+    int references;
+};
+
+struct tree_t {
+    TreeNode root;
+    int size;
+    Pool pool;  // the nodes of the tree, shared with its copies
+    size_t node_size;
+    bool is_inline;  // keys and data are stored inside the nodes and copied with memcpy
+    size_t key_size;
+    size_t data_size;
+    copyTreeDataElement copyData;
+    copyTreeKeyElement copyKey;
+    freeTreeDataElement freeData;
+    freeTreeKeyElement freeKey;
+    compareTreeKeyElements compare;
+};
+
+// HELPER FUNCTIONS START
+
+static size_t alignedSize(size_t size)
+{
+    return (size + sizeof(TreeAlignment) - 1) / sizeof(TreeAlignment) * sizeof(TreeAlignment);
+}
+
+// allocates an empty tree whose nodes are allocated from pool, or from a new pool if pool is NULL.
+static Tree treeAllocate(bool is_inline, size_t key_size, size_t data_size, compareTreeKeyElements compare,
+                         Pool pool)
+{
+    Tree tree = malloc(sizeof(*tree));
+    if(tree == NULL)
+    {
+        return NULL;
+    }
+    tree->node_size = sizeof(struct tree_node_t);
+    if(is_inline)
+    {
+        tree->node_size = alignedSize(tree->node_size) + alignedSize(key_size) + data_size;
+    }
+    tree->pool = pool == NULL ? poolCreate(tree->node_size) : poolShare(pool);
+    if(tree->pool == NULL)
+    {
+        free(tree);
+        return NULL;
+    }
+    tree->root = NULL;
+    tree->size = 0;
+    tree->is_inline = is_inline;
+    tree->key_size = key_size;
+    tree->data_size = data_size;
+    tree->copyData = NULL;
+    tree->copyKey = NULL;
+    tree->freeData = NULL;
+    tree->freeKey = NULL;
+    tree->compare = compare;
+    return tree;
+}
+
+// creates a new node holding copies of key and data. returns NULL on memory allocation error.
+static TreeNode nodeCreate(Tree tree, TreeKeyElement key, TreeDataElement data)
+{
+    TreeNode node = poolAlloc(tree->pool);
+    if(node == NULL)
+    {
+        return NULL;
+    }
+    node->left = NULL;
+    node->right = NULL;
+    node->height = 1;
+    node->references = 1;
+    node->element = NULL;
+    if(tree->is_inline)
+    {
+        node->key = (char*)node + alignedSize(sizeof(struct tree_node_t));
+        node->data = (char*)node->key + alignedSize(tree->key_size);
+        memcpy(node->key, key, tree->key_size);
+        memcpy(node->data, data, tree->data_size);
+        return node;
+    }
+    node->key = tree->copyKey(key);
+    node->data = tree->copyData(data);
+    if(node->key == NULL || node->data == NULL)
+    {
+        tree->freeKey(node->key);
+        tree->freeData(node->data);
+        poolFree(tree->pool, node);
+        return NULL;
+    }
+    return node;
+}
+
+// frees the key and data of a node, but not the node itself. shared key and data are freed by their last node.
+static void nodeFreeElement(Tree tree, TreeNode node)
+{
+    if(tree->is_inline)
+    {
+        return;
+    }
+    if(node->element != NULL)
+    {
+        node->element->references--;
+        if(node->element->references > 0)
+        {
+            node->element = NULL;
+            return;
+        }
+        poolFree(tree->pool, node->element);
+        node->element = NULL;
+    }
+    tree->freeData(node->data);
+    tree->freeKey(node->key);
+}
+
+/**
+ * nodeMutable: returns a node which may be changed in place of node, which is pointed to by a node (or tree)
+ * that may be changed. if node is shared with other trees, it is copied and the copy should replace it.
+ * the copy shares the children of node and, unless the tree is inline, also its key and data.
+ * the pool must have a free element reserved for the copy, and one more for a new shared element.
+*/
+static TreeNode nodeMutable(Tree tree, TreeNode node)
+{
+    if(node == NULL || node->references == 1)
+    {
+        return node;
+    }
+    TreeNode copy = poolAlloc(tree->pool);
+    if(tree->is_inline)
+    {
+        memcpy(copy, node, tree->node_size);
+        copy->key = (char*)copy + ((char*)node->key - (char*)node);
+        copy->data = (char*)copy + ((char*)node->data - (char*)node);
+    }
+    else
+    {
+        *copy = *node;
+        if(node->element == NULL)
+        {
+            node->element = poolAlloc(tree->pool);
+            node->element->key = node->key;
+            node->element->data = node->data;
+            node->element->references = 1;
+        }
+        copy->element = node->element;
+        copy->element->references++;
+    }
+    copy->references = 1;
+    if(copy->left != NULL)
+    {
+        copy->left->references++;
+    }
+    if(copy->right != NULL)
+    {
+        copy->right->references++;
+    }
+    node->references--;
+    return copy;
+}
+
+// reserves the nodes which nodeMutable may need during a single change of the tree. returns false on
+// memory allocation error.
+static bool treeReserveForWrite(Tree tree)
+{
+    if(poolIsShared(tree->pool) == false)  // no node is shared, so nothing is copied
+    {
+        return true;
+    }
+    int height = tree->root == NULL ? 0 : tree->root->height;
+    return poolReserve(tree->pool, TREE_COPIES_PER_LEVEL * (height + 2));
+}
+
+// makes the key and data of a node private to it, copying them if they are shared. returns false on
+// memory allocation error.
+static bool nodeOwnElement(Tree tree, TreeNode node)
+{
+    if(tree->is_inline || node->element == NULL)
+    {
+        return true;
+    }
+    if(node->element->references == 1)
+    {
+        poolFree(tree->pool, node->element);
+        node->element = NULL;
+        return true;
+    }
+    TreeKeyElement key = tree->copyKey(node->key);
+    TreeDataElement data = tree->copyData(node->data);
+    if(key == NULL || data == NULL)
+    {
+        tree->freeKey(key);
+        tree->freeData(data);
+        return false;
+    }
+    node->element->references--;
+    node->element = NULL;
+    node->key = key;
+    node->data = data;
+    return true;
+}
+
+// removes a reference to the sub tree of node. nodes which are not referenced anymore are freed.
+static void nodeRelease(Tree tree, TreeNode node)
+{
+    if(node == NULL)
+    {
+        return;
+    }
+    node->references--;
+    if(node->references > 0)
+    {
+        return;
+    }
+    nodeRelease(tree, node->left);
+    nodeRelease(tree, node->right);
+    nodeFreeElement(tree, node);
+    poolFree(tree->pool, node);
+}
+
+static int nodeHeight(TreeNode node)
+{
+    return node == NULL ? 0 : node->height;
+}
+
+static void nodeUpdateHeight(TreeNode node)
+{
+    int left = nodeHeight(node->left);
+    int right = nodeHeight(node->right);
+    node->height = 1 + (left > right ? left : right);
+}
+
+// both rotations change node and the child which replaces it, so node must be mutable.
+static TreeNode nodeRotateRight(Tree tree, TreeNode node)
+{
+    TreeNode new_root = nodeMutable(tree, node->left);
+    node->left = new_root->right;
+    new_root->right = node;
+    nodeUpdateHeight(node);
+    nodeUpdateHeight(new_root);
+    return new_root;
+}
+
+static TreeNode nodeRotateLeft(Tree tree, TreeNode node)
+{
+    TreeNode new_root = nodeMutable(tree, node->right);
+    node->right = new_root->left;
+    new_root->left = node;
+    nodeUpdateHeight(node);
+    nodeUpdateHeight(new_root);
+    return new_root;
+}
+
+// restores the AVL property of a mutable node, assuming both of its sub trees are balanced.
+// returns the new sub tree root.
+static TreeNode nodeBalance(Tree tree, TreeNode node)
+{
+    nodeUpdateHeight(node);
+    int balance = nodeHeight(node->left) - nodeHeight(node->right);
+    if(balance > 1)
+    {
+        if(nodeHeight(node->left->left) < nodeHeight(node->left->right))
+        {
+            node->left = nodeRotateLeft(tree, nodeMutable(tree, node->left));
+        }
+        return nodeRotateRight(tree, node);
+    }
+    if(balance < -1)
+    {
+        if(nodeHeight(node->right->right) < nodeHeight(node->right->left))
+        {
+            node->right = nodeRotateRight(tree, nodeMutable(tree, node->right));
+        }
+        return nodeRotateLeft(tree, node);
+    }
+    return node;
+}
+
+// frees the elements of the sub tree. the nodes themselves are freed later all at once, with the pool.
+// the nodes must not be shared with other trees.
+static void nodeFreeElements(Tree tree, TreeNode node)
+{
+    if(node == NULL || tree->is_inline)  // inline elements are freed with their nodes
+    {
+        return;
+    }
+    nodeFreeElements(tree, node->left);
+    nodeFreeElements(tree, node->right);
+    nodeFreeElement(tree, node);
+}
+
+// releases all the nodes of the tree. when no node is shared, they are freed at once with the pool.
+static void treeReleaseAll(Tree tree, bool destroy_pool)
+{
+    if(poolIsShared(tree->pool))
+    {
+        nodeRelease(tree, tree->root);
+        if(destroy_pool)
+        {
+            poolDestroy(tree->pool);
+        }
+        return;
+    }
+    nodeFreeElements(tree, tree->root);
+    if(destroy_pool)
+    {
+        poolDestroy(tree->pool);
+    }
+    else
+    {
+        poolClear(tree->pool);
+    }
+}
+
+// gives a mutable node, whose key equals the key of new_node, the data of new_node. new_node holds copies
+// of its key and data (or owns them), and is freed.
+static void nodeReplaceData(Tree tree, TreeNode node, TreeNode new_node)
+{
+    if(tree->is_inline)
+    {
+        memcpy(node->data, new_node->data, tree->data_size);
+    }
+    else if(node->element != NULL)  // the key and data are shared, so they are only released
+    {
+        nodeFreeElement(tree, node);
+        node->key = new_node->key;
+        node->data = new_node->data;
+    }
+    else
+    {
+        if(node->data != new_node->data)
+        {
+            tree->freeData(node->data);
+            node->data = new_node->data;
+        }
+        if(node->key != new_node->key)
+        {
+            tree->freeKey(new_node->key);
+        }
+    }
+    poolFree(tree->pool, new_node);
+}
+
+/**
+ * nodeInsert: inserts new_node into the sub tree of node, or replaces the data of the node with an equal key.
+ *
+ * @param tree - the tree which node belongs to.
+ * @param node - root of the sub tree.
+ * @param new_node - an allocated node holding copies of the key and data.
+ * @param inserted - set to false if an equal key was found, in which case new_node's data replaces the data of
+ *      that node and new_node is freed.
+ * @return
+ *   the new root of the sub tree.
+*/
+static TreeNode nodeInsert(Tree tree, TreeNode node, TreeNode new_node, bool* inserted)
+{
+    if(node == NULL)
+    {
+        *inserted = true;
+        return new_node;
+    }
+    node = nodeMutable(tree, node);
+    int compare_result = tree->compare(new_node->key, node->key);
+    if(compare_result == 0)
+    {
+        nodeReplaceData(tree, node, new_node);
+        *inserted = false;
+        return node;
+    }
+    if(compare_result < 0)
+    {
+        node->left = nodeInsert(tree, node->left, new_node, inserted);
+    }
+    else
+    {
+        node->right = nodeInsert(tree, node->right, new_node, inserted);
+    }
+    return *inserted ? nodeBalance(tree, node) : node;
+}
+
+// inserts a new node holding copies of (or owning) its key and data into the tree.
+static void treeInsert(Tree tree, TreeNode new_node)
+{
+    bool inserted = false;
+    tree->root = nodeInsert(tree, tree->root, new_node, &inserted);
+    tree->size += inserted;
+}
+
+// detaches the smallest node of the sub tree into *min_node and returns the new sub tree root.
+static TreeNode nodeDetachMin(Tree tree, TreeNode node, TreeNode* min_node)
+{
+    node = nodeMutable(tree, node);
+    if(node->left == NULL)
+    {
+        *min_node = node;
+        return node->right;
+    }
+    node->left = nodeDetachMin(tree, node->left, min_node);
+    return nodeBalance(tree, node);
+}
+
+// removes the node whose key equals key from the sub tree. sets *removed accordingly.
+static TreeNode nodeRemove(Tree tree, TreeNode node, TreeKeyElement key, bool* removed)
+{
+    if(node == NULL)
+    {
+        *removed = false;
+        return NULL;
+    }
+    node = nodeMutable(tree, node);
+    int compare_result = tree->compare(key, node->key);
+    if(compare_result < 0)
+    {
+        node->left = nodeRemove(tree, node->left, key, removed);
+    }
+    else if(compare_result > 0)
+    {
+        node->right = nodeRemove(tree, node->right, key, removed);
+    }
+    else
+    {
+        // the children of node keep their references, which move to the replacement.
+        TreeNode replacement = NULL;
+        if(node->left == NULL)
+        {
+            replacement = node->right;
+        }
+        else if(node->right == NULL)
+        {
+            replacement = node->left;
+        }
+        else
+        {
+            TreeNode right = nodeDetachMin(tree, node->right, &replacement);
+            replacement->right = right;
+            replacement->left = node->left;
+            replacement = nodeBalance(tree, replacement);
+        }
+        nodeFreeElement(tree, node);
+        poolFree(tree->pool, node);
+        *removed = true;
+        return replacement;
+    }
+    return *removed ? nodeBalance(tree, node) : node;
+}
+
+// HELPER FUNCTIONS END
+
+Tree treeCreate(copyTreeDataElement copyData, copyTreeKeyElement copyKey,
+                freeTreeDataElement freeData, freeTreeKeyElement freeKey, compareTreeKeyElements compare)
+{
+    if(!copyData || !copyKey || !freeData || !freeKey || !compare)
+    {
+        return NULL;
+    }
+    Tree tree = treeAllocate(false, 0, 0, compare, NULL);
+    if(tree == NULL)
+    {
+        return NULL;
+    }
+    tree->copyData = copyData;
+    tree->copyKey = copyKey;
+    tree->freeData = freeData;
+    tree->freeKey = freeKey;
+    return tree;
+}
+
+Tree treeCreateInline(size_t key_size, size_t data_size, compareTreeKeyElements compare)
+{
+    if(key_size == 0 || !compare)
+    {
+        return NULL;
+    }
+    return treeAllocate(true, key_size, data_size, compare, NULL);
+}
+
+void treeDestroy(Tree tree)
+{
+    if(tree == NULL)
+    {
+        return;
+    }
+    treeReleaseAll(tree, true);
+    free(tree);
+}
+
+Tree treeCopy(Tree tree)
+{
+    if(tree == NULL)
+    {
+        return NULL;
+    }
+    Tree new_tree = treeAllocate(tree->is_inline, tree->key_size, tree->data_size, tree->compare, tree->pool);
+    if(new_tree == NULL)
+    {
+        return NULL;
+    }
+    new_tree->copyData = tree->copyData;
+    new_tree->copyKey = tree->copyKey;
+    new_tree->freeData = tree->freeData;
+    new_tree->freeKey = tree->freeKey;
+    new_tree->root = tree->root;
+    new_tree->size = tree->size;
+    if(new_tree->root != NULL)
+    {
+        new_tree->root->references++;
+    }
+    return new_tree;
+}
+
+bool treeIsShared(Tree tree)
+{
+    return tree != NULL && poolIsShared(tree->pool);
+}
+
+int treeGetSize(Tree tree)
+{
+    if(tree == NULL)
+    {
+        return -1;
+    }
+    return tree->size;
+}
+
+TreeNode treeFind(Tree tree, TreeKeyElement key)
+{
+    if(tree == NULL || key == NULL)
+    {
+        return NULL;
+    }
+    TreeNode node = tree->root;
+    while(node)
+    {
+        int compare_result = tree->compare(key, node->key);
+        if(compare_result == 0)
+        {
+            return node;
+        }
+        node = compare_result < 0 ? node->left : node->right;
+    }
+    return NULL;
+}
+
+TreeNode treeFindForWrite(Tree tree, TreeKeyElement key)
+{
+    if(treeIsShared(tree) == false)
+    {
+        return treeFind(tree, key);
+    }
+    if(treeFind(tree, key) == NULL || treeReserveForWrite(tree) == false)
+    {
+        return NULL;
+    }
+    // copying the shared nodes on the path to the node, so changing it does not change other trees.
+    TreeNode* link = &tree->root;
+    while(true)
+    {
+        *link = nodeMutable(tree, *link);
+        int compare_result = tree->compare(key, (*link)->key);
+        if(compare_result == 0)
+        {
+            break;
+        }
+        link = compare_result < 0 ? &(*link)->left : &(*link)->right;
+    }
+    return nodeOwnElement(tree, *link) ? *link : NULL;
+}
+
+TreeError treePut(Tree tree, TreeKeyElement key, TreeDataElement data)
+{
+    if(tree == NULL || key == NULL || data == NULL)
+    {
+        return TREE_NULL_ARGUMENT;
+    }
+    TreeNode new_node = nodeCreate(tree, key, data);
+    if(new_node == NULL)
+    {
+        return TREE_OUT_OF_MEMORY;
+    }
+    if(treeReserveForWrite(tree) == false)
+    {
+        nodeFreeElement(tree, new_node);
+        poolFree(tree->pool, new_node);
+        return TREE_OUT_OF_MEMORY;
+    }
+    treeInsert(tree, new_node);
+    return TREE_SUCCESS;
+}
+
+TreeError treePutTake(Tree tree, TreeKeyElement key, TreeDataElement data)
+{
+    if(tree == NULL || key == NULL || data == NULL || tree->is_inline)
+    {
+        return TREE_NULL_ARGUMENT;
+    }
+    TreeNode new_node = poolAlloc(tree->pool);
+    if(new_node == NULL)
+    {
+        return TREE_OUT_OF_MEMORY;
+    }
+    if(treeReserveForWrite(tree) == false)
+    {
+        poolFree(tree->pool, new_node);
+        return TREE_OUT_OF_MEMORY;
+    }
+    new_node->key = key;
+    new_node->data = data;
+    new_node->left = NULL;
+    new_node->right = NULL;
+    new_node->height = 1;
+    new_node->references = 1;
+    new_node->element = NULL;
+    treeInsert(tree, new_node);
+    return TREE_SUCCESS;
+}
+
+TreeError treeRemove(Tree tree, TreeKeyElement key)
+{
+    if(tree == NULL || key == NULL)
+    {
+        return TREE_NULL_ARGUMENT;
+    }
+    if(treeIsShared(tree) && treeFind(tree, key) == NULL)  // so the path is not copied for nothing
+    {
+        return TREE_ITEM_DOES_NOT_EXIST;
+    }
+    if(treeReserveForWrite(tree) == false)
+    {
+        return TREE_OUT_OF_MEMORY;
+    }
+    bool removed = false;
+    tree->root = nodeRemove(tree, tree->root, key, &removed);
+    if(removed == false)
+    {
+        return TREE_ITEM_DOES_NOT_EXIST;
+    }
+    tree->size--;
+    return TREE_SUCCESS;
+}
+
+void treeClear(Tree tree)
+{
+    if(tree == NULL)
+    {
+        return;
+    }
+    treeReleaseAll(tree, false);
+    tree->root = NULL;
+    tree->size = 0;
+}
+
+TreeNode treeGetFirst(Tree tree)
+{
+    if(tree == NULL || tree->root == NULL)
+    {
+        return NULL;
+    }
+    TreeNode node = tree->root;
+    while(node->left)
+    {
+        node = node->left;
+    }
+    return node;
+}
+
+TreeNode treeGetNext(Tree tree, TreeKeyElement key)
+{
+    if(tree == NULL || key == NULL)
+    {
+        return NULL;
+    }
+    TreeNode node = tree->root;
+    TreeNode next = NULL;
+    while(node)
+    {
+        if(tree->compare(key, node->key) < 0)
+        {
+            next = node;
+            node = node->left;
+        }
+        else
+        {
+            node = node->right;
+        }
+    }
+    return next;
+}
+
+TreeNode treeLowerBound(Tree tree, TreeKeyElement key)
+{
+    if(tree == NULL || key == NULL)
+    {
+        return NULL;
+    }
+    TreeNode node = tree->root;
+    TreeNode bound = NULL;
+    while(node)
+    {
+        if(tree->compare(key, node->key) <= 0)
+        {
+            bound = node;
+            node = node->left;
+        }
+        else
+        {
+            node = node->right;
+        }
+    }
+    return bound;
+}
+
+PoolStatistics treeGetStatistics(Tree tree)
+{
+    return poolGetStatistics(tree == NULL ? NULL : tree->pool);
+}
@@ -0,0 +1,98 @@
+#ifndef TREE_H
+#define TREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "pool.h"
+
+/**
+ * Balanced (AVL) binary search tree of key:data elements.
+ * Used by the map as an alternative to the linked list backend, so lookups, inserts and removes
+ * take O(log n) while the keys are still kept ordered.
+ * Copies of a tree share its nodes (copy on write): a node is copied only when a tree which shares it
+ * changes it or one of its descendants, and then its key and data are still shared until they are
+ * accessed by treeFindForWrite or replaced.
+*/
+
+typedef void* TreeKeyElement;
+typedef void* TreeDataElement;
+
+typedef TreeDataElement (*copyTreeDataElement)(TreeDataElement);
+typedef TreeKeyElement (*copyTreeKeyElement)(TreeKeyElement);
+typedef void (*freeTreeDataElement)(TreeDataElement);
+typedef void (*freeTreeKeyElement)(TreeKeyElement);
+typedef int (*compareTreeKeyElements)(TreeKeyElement, TreeKeyElement);
+
+struct tree_node_t {
+    TreeKeyElement key;
+    TreeDataElement data;
+    struct tree_node_t *left;
+    struct tree_node_t *right;
+    int height;
+    int references;  // amount of parents and trees pointing to the node
+    struct tree_element_t *element;  // NULL unless the key and data are shared with nodes of other trees
+};
+
+typedef struct tree_node_t *TreeNode;
+
+typedef struct tree_t *Tree;
+
+typedef enum {
+    TREE_SUCCESS, TREE_OUT_OF_MEMORY, TREE_NULL_ARGUMENT, TREE_ITEM_DOES_NOT_EXIST
+} TreeError;
+
+// creates a new empty tree. returns NULL if one of the arguments is NULL or on memory allocation error.
+Tree treeCreate(copyTreeDataElement copyData, copyTreeKeyElement copyKey,
+                freeTreeDataElement freeData, freeTreeKeyElement freeKey, compareTreeKeyElements compare);
+
+// creates a new empty tree whose keys and data are stored inside its nodes. keys are key_size bytes
+// and data are data_size bytes, and both are copied with memcpy. returns NULL if key_size is 0, if compare
+// is NULL or on memory allocation error.
+Tree treeCreateInline(size_t key_size, size_t data_size, compareTreeKeyElements compare);
+
+// frees all the nodes of the tree (using the free functions), then frees the tree.
+void treeDestroy(Tree tree);
+
+// returns a copy of the tree which shares all of its nodes, in O(1). returns NULL on memory allocation error.
+Tree treeCopy(Tree tree);
+
+// returns true if the tree may share nodes with copies of it.
+bool treeIsShared(Tree tree);
+
+// returns the amount of elements in the tree, or -1 if tree is NULL.
+int treeGetSize(Tree tree);
+
+// returns the node whose key equals key (NOT a copy), or NULL if there is no such node.
+// the data of the node must not be changed, since it may be shared with copies of the tree.
+TreeNode treeFind(Tree tree, TreeKeyElement key);
+
+// same as treeFind, but first makes the node and its data private to tree, so its data may be changed.
+// returns NULL if there is no such node or on memory allocation error.
+TreeNode treeFindForWrite(Tree tree, TreeKeyElement key);
+
+// inserts a copy of key and data into the tree. if the key exists only its data is replaced.
+TreeError treePut(Tree tree, TreeKeyElement key, TreeDataElement data);
+
+// same as treePut, but the tree takes ownership of key and data instead of copying them. if the key exists,
+// the given key is freed. tree must not be inline. on failure key and data are not taken.
+TreeError treePutTake(Tree tree, TreeKeyElement key, TreeDataElement data);
+
+// removes and frees the element whose key equals key.
+TreeError treeRemove(Tree tree, TreeKeyElement key);
+
+// removes and frees all the elements of the tree. the nodes are freed at once.
+void treeClear(Tree tree);
+
+// returns the node with the smallest key, or NULL if the tree is empty.
+TreeNode treeGetFirst(Tree tree);
+
+// returns the node with the smallest key greater than key, or NULL if there is none.
+TreeNode treeGetNext(Tree tree, TreeKeyElement key);
+
+// returns the node with the smallest key greater than or equal to key, or NULL if there is none.
+TreeNode treeLowerBound(Tree tree, TreeKeyElement key);
+
+// returns the allocation statistics of the nodes of the tree.
+PoolStatistics treeGetStatistics(Tree tree);
+
+#endif